@@ -0,0 +1,20 @@
+struct FragmentIn {
+    float4 pos_h : SV_POSITION;
+    location(0) float4 color : COLOR;
+    location(1) float2 texcoord : TEXCOORD;
+};
+
+struct BindlessIndices {
+    uint texture_index;
+    uint sampler_index;
+};
+
+[[vk::push_constant]] ConstantBuffer<BindlessIndices> indices;
+
+// Arrays of the global bindless set
+[[vk::binding(0, 1)]] Texture2D textures[] : register(t0, space1);
+[[vk::binding(1, 1)]] SamplerState samplers[] : register(s0, space1);
+
+float4 main(in FragmentIn input) : SV_TARGET {
+    return input.color * textures[indices.texture_index].Sample(samplers[indices.sampler_index], input.texcoord);
+}
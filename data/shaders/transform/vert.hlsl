@@ -2,10 +2,12 @@ struct VertexIn {
     location(0) float3 pos : POSITION;
     location(1) float3 normal : NORMAL;
     location(2) float2 texcoord : TEXCOORD;
+    location(3) float3 instance_offset : INSTANCE_OFFSET;
 };
 
 struct CB0 {
     row_major float4x4 mvp;
+    row_major float4x4 vp;
     row_major float3x3 mv;
 };
 
@@ -20,7 +22,7 @@ struct VertexOut {
 VertexOut main(in VertexIn input) {
     VertexOut output;
     float3 normal = mul(input.normal, cb0.mv);
-    output.pos_h = mul(float4(input.pos, 1.0), cb0.mvp);
+    output.pos_h = mul(float4(input.pos, 1.0), cb0.mvp) + mul(float4(input.instance_offset, 0.0), cb0.vp);
     output.color = max(0.0, dot(normal, float3(0.58, 0.58, 0.58))) + 0.1;
     output.texcoord = input.texcoord;
     return output;
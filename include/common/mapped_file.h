@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace app3d {
+
+class APP3D_COMMON_EXPORT MappedFile {
+ public:
+    MappedFile() noexcept = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::filesystem::path& file_path);
+    void close();
+
+    bool isOpen() const noexcept { return data_ != nullptr; }
+    const std::uint8_t* getData() const noexcept { return data_; }
+    std::size_t getSize() const noexcept { return size_; }
+    std::span<const std::uint8_t> getBuffer() const noexcept { return std::span{data_, size_}; }
+
+ private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace app3d
@@ -8,6 +8,8 @@
 
 #include <uxs/db/value.h>
 
+#include <optional>
+
 #if defined(WIN32)
 #    define APP3D_ENTRY_EXPORT extern "C" __declspec(dllexport)
 #elif defined(__linux__)
@@ -33,55 +35,124 @@ enum class RenderTargetResult {
     FAILED,
 };
 
+enum class PipelineStatus {
+    PENDING = 0,
+    READY,
+    FAILED,
+};
+
 struct IShaderModule {
     virtual ~IShaderModule() = default;
     virtual util::ref_counter& getRefCounter() = 0;
 };
 
 struct IDescriptorSet;
+struct IDescriptorSetCache;
+struct IRenderTarget;
 struct IPipelineLayout {
     virtual ~IPipelineLayout() = default;
     virtual util::ref_counter& getRefCounter() = 0;
     virtual util::ref_ptr<IDescriptorSet> createDescriptorSet(std::uint32_t set_layout_index) = 0;
+    // Returned set is valid only until the current frame of the render target is finished, so it must be
+    // allocated between `beginRenderTarget` and `endRenderTarget` calls
+    virtual IDescriptorSet* createTransientDescriptorSet(IRenderTarget& render_target,
+                                                         std::uint32_t set_layout_index) = 0;
     virtual void resetDescriptorAllocator() = 0;
+    // Sets which haven't been obtained from the cache for `max_unused_frames` frames are evicted, so this value must
+    // not be less than the count of frames in flight
+    virtual util::ref_ptr<IDescriptorSetCache> createDescriptorSetCache(std::uint32_t max_unused_frames) = 0;
 };
 
 struct IPipeline {
     virtual ~IPipeline() = default;
     virtual util::ref_counter& getRefCounter() = 0;
+    // Only ready pipelines can be bound
+    virtual PipelineStatus getStatus() const = 0;
 };
 
 struct IBuffer {
     virtual ~IBuffer() = default;
     virtual util::ref_counter& getRefCounter() = 0;
     virtual bool updateBuffer(std::span<const std::uint8_t> data, std::uint64_t offset) = 0;
+    // Index in the bindless buffer array or `INVALID_UINT32_VALUE`, if the buffer isn't there
+    virtual std::uint32_t getBindlessIndex() const = 0;
 };
 
-struct IRenderTarget;
 struct ITexture {
     virtual ~ITexture() = default;
     virtual util::ref_counter& getRefCounter() = 0;
     virtual bool updateTexture(const std::uint8_t* data, std::uint32_t first_subresource,
                                std::span<const UpdateTextureDesc> update_subresource_descs) = 0;
     virtual util::ref_ptr<IRenderTarget> createRenderTarget(const uxs::db::value& opts) = 0;
+    // Index in the bindless texture array or `INVALID_UINT32_VALUE`, if bindless mode is off
+    virtual std::uint32_t getBindlessIndex() const = 0;
 };
 
 struct ISampler {
     virtual ~ISampler() = default;
     virtual util::ref_counter& getRefCounter() = 0;
+    // Index in the bindless sampler array or `INVALID_UINT32_VALUE`, if bindless mode is off
+    virtual std::uint32_t getBindlessIndex() const = 0;
+};
+
+// Resource referenced by one descriptor of a set
+struct DescriptorData {
+    ITexture* texture = nullptr;
+    ISampler* sampler = nullptr;
+    IBuffer* buffer = nullptr;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
 };
 
 struct IDescriptorSet {
     virtual ~IDescriptorSet() = default;
     virtual util::ref_counter& getRefCounter() = 0;
+    // Writes all descriptors of the set at once, data items follow in order of set layout descriptors, array
+    // elements of a descriptor are consecutive
+    virtual void updateDescriptors(std::span<const DescriptorData> descriptors) = 0;
     virtual void updateSamplerDescriptor(ISampler& sampler, std::uint32_t slot) = 0;
     virtual void updateCombinedTextureSamplerDescriptor(ITexture& texture, ISampler& sampler, std::uint32_t slot,
                                                         std::uint32_t sampler_slot) = 0;
+    // Writes only the texture of a combined descriptor, which has an immutable sampler
+    virtual void updateCombinedTextureSamplerDescriptor(ITexture& texture, std::uint32_t slot) = 0;
     virtual void updateShaderResourceDescriptor(ITexture& texture, std::uint32_t slot) = 0;
     virtual void updateConstantBufferDescriptor(IBuffer& buffer, std::uint64_t offset, std::uint64_t size,
                                                 std::uint32_t slot) = 0;
 };
 
+struct IDescriptorSetCache {
+    virtual ~IDescriptorSetCache() = default;
+    virtual util::ref_counter& getRefCounter() = 0;
+    // Returns existing set with the same content or creates a new one, the set must not be updated
+    virtual IDescriptorSet* obtainDescriptorSet(std::uint32_t set_layout_index,
+                                                std::span<const DescriptorData> descriptors) = 0;
+    // Must be called once per frame
+    virtual void nextFrame() = 0;
+};
+
+// State and arguments of one draw, null objects and absent topology leave previously bound ones; with an index buffer
+// the draw is indexed: index range and `base_vertex` are used instead of vertex range
+struct DrawPacket {
+    IPipeline* pipeline = nullptr;
+    IBuffer* vertex_buffer = nullptr;
+    std::uint32_t vertex_stride = 0;
+    std::uint32_t vertex_offset = 0;
+    IBuffer* index_buffer = nullptr;
+    std::uint64_t index_offset = 0;
+    IndexType index_type = IndexType::UINT16;
+    std::uint32_t index_count = 0;
+    std::uint32_t first_index = 0;
+    std::int32_t base_vertex = 0;
+    IDescriptorSet* descriptor_set = nullptr;
+    std::uint32_t set_index = 0;
+    std::span<const std::uint32_t> dynamic_offsets;
+    std::optional<PrimitiveTopology> topology;  // can be set only if it's dynamic in the config of the pipeline
+    std::uint32_t vertex_count = 0;
+    std::uint32_t instance_count = 1;
+    std::uint32_t first_vertex = 0;
+    std::uint32_t first_instance = 0;
+};
+
 struct IRenderTarget {
     virtual ~IRenderTarget() = default;
     virtual util::ref_counter& getRefCounter() = 0;
@@ -95,12 +166,52 @@ struct IRenderTarget {
     virtual void setScissor(const Rect& rect) = 0;
     virtual void bindPipeline(IPipeline& pipeline) = 0;
     virtual void bindVertexBuffer(IBuffer& buffer, std::uint32_t slot, std::uint32_t stride, std::uint32_t offset) = 0;
+    virtual void bindIndexBuffer(IBuffer& buffer, std::uint64_t offset, IndexType index_type) = 0;
     virtual void bindDescriptorSet(IDescriptorSet& descriptor_set, std::uint32_t set_index) = 0;
     virtual void bindDescriptorSetDynamic(IDescriptorSet& descriptor_set, std::uint32_t set_index,
                                           std::span<const std::uint32_t> offsets) = 0;
+    // Updated range must be contained in the push constant range of the stage, `ALL_STAGES` stands for stages of all
+    // ranges overlapping the updated one
+    virtual void pushConstants(ShaderStage stage, std::uint32_t offset, std::span<const std::uint8_t> data) = 0;
+    // Writes descriptors of a set marked as "push" in the layout of current pipeline directly to the command buffer,
+    // data items follow in order of set layout descriptors
+    virtual void pushDescriptors(std::uint32_t set_index, std::span<const DescriptorData> descriptors) = 0;
+    // Binds the global bindless set to the index given by `bindless_set` of current pipeline layout
+    virtual void bindBindlessDescriptorSet() = 0;
     virtual void setPrimitiveTopology(PrimitiveTopology topology) = 0;
+    // Fixed-function state can be set only if it's marked as dynamic in the config of current pipeline, and it must
+    // be set again after another pipeline is bound; if the driver uses shader objects, binding a pipeline resets all
+    // fixed-function state to the pipeline config, and the render target replays the state set by these methods
+    virtual void setCullMode(CullMode cull_mode) = 0;
+    virtual void setFrontFace(FrontFace front_face) = 0;
+    virtual void setDepthTest(bool enable, bool write_enable, CompareOp compare_op) = 0;
+    virtual void setDepthBias(bool enable, float constant_factor, float clamp, float slope_factor) = 0;
+    virtual void setPolygonMode(PolygonMode polygon_mode) = 0;
+    virtual void setBlendState(bool enable, const BlendEquation& equation) = 0;
     virtual void drawGeometry(std::uint32_t vertex_count, std::uint32_t instance_count, std::uint32_t first_vertex,
                               std::uint32_t first_instance) = 0;
+    virtual void drawIndexedGeometry(std::uint32_t index_count, std::uint32_t instance_count, std::uint32_t first_index,
+                                     std::int32_t vertex_offset, std::uint32_t first_instance) = 0;
+    // Arguments of indirect draws are `DrawIndirectArgs` or `DrawIndexedIndirectArgs` records read by the device
+    // from buffers of `INDIRECT` type, zero `stride` means tightly packed records; draws exceeding device limits are
+    // split into several commands
+    virtual void drawIndirect(IBuffer& buffer, std::uint64_t offset, std::uint32_t draw_count,
+                              std::uint32_t stride) = 0;
+    virtual void drawIndexedIndirect(IBuffer& buffer, std::uint64_t offset, std::uint32_t draw_count,
+                                     std::uint32_t stride) = 0;
+    // The count of draws is a 32-bit value read from `count_buffer` and limited by `max_draw_count`, so compute
+    // passes can decide how many draws are made; such draws aren't split, so `max_draw_count` must fit device limits
+    virtual void drawIndirectCount(IBuffer& buffer, std::uint64_t offset, IBuffer& count_buffer,
+                                   std::uint64_t count_offset, std::uint32_t max_draw_count, std::uint32_t stride) = 0;
+    virtual void drawIndexedIndirectCount(IBuffer& buffer, std::uint64_t offset, IBuffer& count_buffer,
+                                          std::uint64_t count_offset, std::uint32_t max_draw_count,
+                                          std::uint32_t stride) = 0;
+    // Binds state of each packet and draws it, consecutive packets which differ only in vertex or index ranges are
+    // drawn with one command, if it's supported
+    virtual void submitDrawPackets(std::span<const DrawPacket> packets) = 0;
+    // Pipeline, vertex buffer, descriptor set and topology binds repeating bound state are skipped, the statistics
+    // are collected since the last `beginRenderTarget` call
+    virtual BindStatistics getBindStatistics() const = 0;
 };
 
 struct ISurface {
@@ -121,13 +232,30 @@ struct IDevice {
     virtual bool waitDevice() = 0;
     virtual util::ref_ptr<ISwapChain> createSwapChain(ISurface& surface, const uxs::db::value& opts) = 0;
     virtual util::ref_ptr<IShaderModule> createShaderModule(DataBlob bytecode) = 0;
-    virtual util::ref_ptr<IPipelineLayout> createPipelineLayout(const uxs::db::value& config) = 0;
+    // Bytecode aligned to 4 bytes is read while the module is created, so it can be a view of a mapped file
+    virtual util::ref_ptr<IShaderModule> createShaderModule(std::span<const std::uint8_t> bytecode) = 0;
+    // Samplers are referenced from layout config by their indices in `immutable_samplers` list
+    virtual util::ref_ptr<IPipelineLayout> createPipelineLayout(const uxs::db::value& config,
+                                                                std::span<ISampler* const> immutable_samplers) = 0;
+    virtual util::ref_ptr<IPipelineLayout> createPipelineLayout(std::span<IShaderModule* const> shader_modules,
+                                                                const uxs::db::value& config,
+                                                                std::span<ISampler* const> immutable_samplers) = 0;
     virtual util::ref_ptr<IPipeline> createPipeline(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
                                                     std::span<IShaderModule* const> shader_modules,
                                                     const uxs::db::value& config) = 0;
+    // Returns a pending pipeline at once, it's compiled on a worker thread; a fallback pipeline is to be used until
+    // it becomes ready
+    virtual util::ref_ptr<IPipeline> createPipelineAsync(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
+                                                         std::span<IShaderModule* const> shader_modules,
+                                                         const uxs::db::value& config) = 0;
     virtual util::ref_ptr<IBuffer> createBuffer(BufferType type, std::uint64_t size) = 0;
     virtual util::ref_ptr<ITexture> createTexture(const TextureDesc& desc) = 0;
     virtual util::ref_ptr<ISampler> createSampler(const SamplerDesc& desc) = 0;
+    // Depth bias, polygon mode and blend state can be dynamic only if the device has optional features
+    virtual bool isDynamicStateSupported(DynamicStateType type) const = 0;
+    // Descriptor updates made between these calls are gathered and applied at once
+    virtual void beginDescriptorUpdates() = 0;
+    virtual void endDescriptorUpdates() = 0;
 };
 
 struct IRenderingDriver {
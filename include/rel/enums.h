@@ -10,6 +10,14 @@ enum class Format {
     R32G32B32_FLOAT,
     R32G32B32A32_FLOAT,
     R8G8B8A8_UNORM,
+    R32_SINT,
+    R32G32_SINT,
+    R32G32B32_SINT,
+    R32G32B32A32_SINT,
+    R32_UINT,
+    R32G32_UINT,
+    R32G32B32_UINT,
+    R32G32B32A32_UINT,
     TOTAL_COUNT,
 };
 
@@ -22,9 +30,24 @@ enum class PrimitiveTopology {
     TOTAL_COUNT,
 };
 
+enum class VertexInputRate {
+    VERTEX = 0,
+    INSTANCE,
+    TOTAL_COUNT,
+};
+
 enum class BufferType {
     VERTEX = 0,
     CONSTANT,
+    STRUCTURED,
+    INDEX,
+    INDIRECT,
+    TOTAL_COUNT,
+};
+
+enum class IndexType {
+    UINT16 = 0,
+    UINT32,
     TOTAL_COUNT,
 };
 
@@ -35,6 +58,14 @@ enum class ShaderStage {
     TOTAL_COUNT,
 };
 
+enum class ConstantType {
+    BOOL = 0,
+    INT,
+    UINT,
+    FLOAT,
+    TOTAL_COUNT,
+};
+
 enum class DescriptorType {
     SAMPLER = 0,
     COMBINED_TEXTURE_SAMPLER,
@@ -82,6 +113,72 @@ enum class SamplerAddressMode {
     TOTAL_COUNT,
 };
 
+enum class CullMode {
+    NONE = 0,
+    FRONT,
+    BACK,
+    TOTAL_COUNT,
+};
+
+enum class FrontFace {
+    COUNTER_CLOCKWISE = 0,
+    CLOCKWISE,
+    TOTAL_COUNT,
+};
+
+enum class PolygonMode {
+    FILL = 0,
+    WIREFRAME,
+    POINT,
+    TOTAL_COUNT,
+};
+
+enum class CompareOp {
+    NEVER = 0,
+    LESS,
+    EQUAL,
+    LESS_EQUAL,
+    GREATER,
+    NOT_EQUAL,
+    GREATER_EQUAL,
+    ALWAYS,
+    TOTAL_COUNT,
+};
+
+enum class BlendFactor {
+    ZERO = 0,
+    ONE,
+    SRC_COLOR,
+    INV_SRC_COLOR,
+    SRC_ALPHA,
+    INV_SRC_ALPHA,
+    DEST_COLOR,
+    INV_DEST_COLOR,
+    DEST_ALPHA,
+    INV_DEST_ALPHA,
+    TOTAL_COUNT,
+};
+
+enum class BlendOp {
+    ADD = 0,
+    SUBTRACT,
+    REV_SUBTRACT,
+    MIN,
+    MAX,
+    TOTAL_COUNT,
+};
+
+// Fixed-function state, which can be set with `IRenderTarget` methods, if it's marked as dynamic in the pipeline config
+enum class DynamicStateType {
+    CULL_MODE = 0,
+    FRONT_FACE,
+    DEPTH_TEST,
+    DEPTH_BIAS,
+    POLYGON_MODE,
+    BLEND_STATE,
+    TOTAL_COUNT,
+};
+
 enum class TextureFlags {
     NONE = 0,
     RENDER_TARGET = 1,
@@ -11,6 +11,9 @@ class APP3D_REL_EXPORT HlslCompiler {
     HlslCompiler();
     ~HlslCompiler();
 
+    // Platform arguments for compiling to SPIR-V, used by Vulkan driver and offline shader bundling
+    static uxs::db::value getSpirvPlatformArgs();
+
     DataBlob compileShader(const DataBlob& source_text, const uxs::db::value& args, DataBlob& compiler_output);
     void setPlatformArgs(const uxs::db::value& platform_args);
 
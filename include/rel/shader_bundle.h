@@ -0,0 +1,62 @@
+#pragma once
+
+#include "data_blob.h"
+
+#include "common/mapped_file.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace app3d::rel {
+
+// Shader bundle file layout (all fields are little-endian 32-bit words):
+//   header:  magic, version, entry count, reserved
+//   entries: name offset, name size, bytecode offset, bytecode size - sorted by name
+//   names and bytecode blobs, each blob is aligned to 8 bytes
+class APP3D_REL_EXPORT ShaderBundle {
+ public:
+    static constexpr std::uint32_t MAGIC = 0x42533341;  // 'A3SB'
+    static constexpr std::uint32_t VERSION = 1;
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t entry_count;
+        std::uint32_t reserved;
+    };
+
+    struct Entry {
+        std::uint32_t name_offset;
+        std::uint32_t name_size;
+        std::uint32_t data_offset;
+        std::uint32_t data_size;
+    };
+
+    bool open(const std::filesystem::path& file_path);
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+    std::uint32_t getShaderCount() const { return std::uint32_t(entries_.size()); }
+    std::span<const std::uint8_t> findShader(std::string_view name) const;
+
+ private:
+    MappedFile file_;
+    std::span<const Entry> entries_;
+
+    std::string_view getEntryName(const Entry& entry) const {
+        return std::string_view{reinterpret_cast<const char*>(file_.getData() + entry.name_offset), entry.name_size};
+    }
+};
+
+class APP3D_REL_EXPORT ShaderBundleWriter {
+ public:
+    void addShader(std::string name, DataBlob bytecode);
+    bool write(const std::filesystem::path& file_path);
+
+ private:
+    std::vector<std::pair<std::string, DataBlob>> shaders_;
+};
+
+}  // namespace app3d::rel
@@ -45,6 +45,37 @@ struct SamplerDesc {
     std::uint32_t max_anisotropy;
 };
 
+struct BlendEquation {
+    BlendFactor src_color_factor;
+    BlendFactor dest_color_factor;
+    BlendOp color_op;
+    BlendFactor src_alpha_factor;
+    BlendFactor dest_alpha_factor;
+    BlendOp alpha_op;
+};
+
+// Arguments of indirect draws, records of these layouts are read from buffers by the device
+struct DrawIndirectArgs {
+    std::uint32_t vertex_count;
+    std::uint32_t instance_count;
+    std::uint32_t first_vertex;
+    std::uint32_t first_instance;
+};
+
+struct DrawIndexedIndirectArgs {
+    std::uint32_t index_count;
+    std::uint32_t instance_count;
+    std::uint32_t first_index;
+    std::int32_t vertex_offset;
+    std::uint32_t first_instance;
+};
+
+// Counts of bind and state commands passed to a render target during a frame
+struct BindStatistics {
+    std::uint64_t emitted_count;
+    std::uint64_t skipped_count;
+};
+
 struct TextureDesc {
     Format format;
     Extent3u extent;
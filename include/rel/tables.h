@@ -16,6 +16,14 @@ constexpr std::array TBL_FORMAT_SIZE{
     std::uint32_t(12),  // R32G32B32_FLOAT
     std::uint32_t(16),  // R32G32B32A32_FLOAT
     std::uint32_t(4),   // R8G8B8A8_UNORM
+    std::uint32_t(4),   // R32_SINT
+    std::uint32_t(8),   // R32G32_SINT
+    std::uint32_t(12),  // R32G32B32_SINT
+    std::uint32_t(16),  // R32G32B32A32_SINT
+    std::uint32_t(4),   // R32_UINT
+    std::uint32_t(8),   // R32G32_UINT
+    std::uint32_t(12),  // R32G32B32_UINT
+    std::uint32_t(16),  // R32G32B32A32_UINT
 };
 
 constexpr std::array TBL_FORMAT_ALIGNMENT{
@@ -25,6 +33,14 @@ constexpr std::array TBL_FORMAT_ALIGNMENT{
     std::uint32_t(4),  // R32G32B32_FLOAT
     std::uint32_t(4),  // R32G32B32A32_FLOAT
     std::uint32_t(4),  // R8G8B8A8_UNORM
+    std::uint32_t(4),  // R32_SINT
+    std::uint32_t(4),  // R32G32_SINT
+    std::uint32_t(4),  // R32G32B32_SINT
+    std::uint32_t(4),  // R32G32B32A32_SINT
+    std::uint32_t(4),  // R32_UINT
+    std::uint32_t(4),  // R32G32_UINT
+    std::uint32_t(4),  // R32G32B32_UINT
+    std::uint32_t(4),  // R32G32B32A32_UINT
 };
 
 constexpr std::array TBL_DESC_BINDING_TYPE{
@@ -48,6 +64,10 @@ constexpr std::array TBL_DESC_BINDING_TYPE{
 APP3D_REL_EXPORT Format parseFormat(std::string_view fmt);
 APP3D_REL_EXPORT ShaderStage parseShaderStage(std::string_view stage);
 APP3D_REL_EXPORT PrimitiveTopology parsePrimitiveTopology(std::string_view topology);
+APP3D_REL_EXPORT VertexInputRate parseVertexInputRate(std::string_view input_rate);
+APP3D_REL_EXPORT ConstantType parseConstantType(std::string_view type);
 APP3D_REL_EXPORT DescriptorType parseDescriptorType(std::string_view type);
+APP3D_REL_EXPORT SamplerFilter parseSamplerFilter(std::string_view filter);
+APP3D_REL_EXPORT SamplerAddressMode parseSamplerAddressMode(std::string_view address_mode);
 
 }  // namespace app3d::rel
@@ -16,6 +16,14 @@ class ref_counter {
     void unref() noexcept {
         if (--ref_count_ == 0) { delete this; }
     }
+    // Fails if the object is being destroyed: used by caches, which don't reference their objects
+    bool try_ref() noexcept {
+        std::uint64_t count = ref_count_;
+        while (count != 0) {
+            if (ref_count_.compare_exchange_weak(count, count + 1)) { return true; }
+        }
+        return false;
+    }
     std::uint64_t ref_count() const noexcept { return ref_count_; }
 
  private:
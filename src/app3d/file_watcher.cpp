@@ -0,0 +1,134 @@
+#include "file_watcher.h"
+
+#include "common/logger.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#    include <poll.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+
+#    include <cerrno>
+#endif
+
+using namespace app3d;
+
+namespace {
+void addChangedFile(std::vector<std::filesystem::path>& changed_files, std::filesystem::path file_path) {
+    file_path = file_path.lexically_normal();
+    if (std::ranges::find(changed_files, file_path) == changed_files.end()) {
+        changed_files.emplace_back(std::move(file_path));
+    }
+}
+}  // namespace
+
+#if defined(__linux__)
+
+// --------------------------------------------------------
+// FileWatcher class implementation (inotify)
+
+FileWatcher::~FileWatcher() {
+    if (fd_ >= 0) { ::close(fd_); }
+}
+
+bool FileWatcher::create(const std::filesystem::path& dir) {
+    fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+        logError("couldn't initialize inotify");
+        return false;
+    }
+
+    if (!addWatch(dir)) { return false; }
+
+    std::error_code ec;
+    for (const auto& dir_entry : std::filesystem::recursive_directory_iterator(dir, ec)) {
+        if (dir_entry.is_directory() && !addWatch(dir_entry.path())) { return false; }
+    }
+
+    if (ec) {
+        logError("couldn't scan directory '{}': {}", dir, ec.message());
+        return false;
+    }
+
+    return true;
+}
+
+bool FileWatcher::addWatch(const std::filesystem::path& dir) {
+    const int wd = ::inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0) {
+        logError("couldn't watch directory '{}'", dir);
+        return false;
+    }
+    watched_dirs_.insert_or_assign(wd, dir);
+    return true;
+}
+
+bool FileWatcher::waitForChanges(std::chrono::milliseconds timeout, std::vector<std::filesystem::path>& changed_files) {
+    pollfd poll_fd{.fd = fd_, .events = POLLIN};
+    const int result = ::poll(&poll_fd, 1, int(timeout.count()));
+    if (result < 0) { return errno == EINTR; }
+    if (result == 0) { return true; }
+
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+        if (length < 0) { return errno == EAGAIN || errno == EINTR; }
+        if (length == 0) { return true; }
+
+        for (const char* p = buffer; p < buffer + length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            auto dir_it = watched_dirs_.find(event->wd);
+            if (dir_it == watched_dirs_.end() || event->len == 0) { continue; }
+
+            auto file_path = dir_it->second / event->name;
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) { addWatch(file_path); }
+            } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                addChangedFile(changed_files, std::move(file_path));
+            }
+        }
+    }
+}
+
+#else
+
+// --------------------------------------------------------
+// FileWatcher class implementation (polling of modification times)
+
+FileWatcher::~FileWatcher() {}
+
+bool FileWatcher::create(const std::filesystem::path& dir) {
+    if (!std::filesystem::is_directory(dir)) {
+        logError("couldn't watch directory '{}'", dir);
+        return false;
+    }
+    dir_ = dir;
+    scanWriteTimes(nullptr);
+    return true;
+}
+
+bool FileWatcher::waitForChanges(std::chrono::milliseconds timeout, std::vector<std::filesystem::path>& changed_files) {
+    std::this_thread::sleep_for(timeout);
+    scanWriteTimes(&changed_files);
+    return true;
+}
+
+void FileWatcher::scanWriteTimes(std::vector<std::filesystem::path>* changed_files) {
+    std::error_code ec;
+    for (const auto& dir_entry : std::filesystem::recursive_directory_iterator(dir_, ec)) {
+        if (!dir_entry.is_regular_file()) { continue; }
+        const auto write_time = dir_entry.last_write_time(ec);
+        if (ec) { continue; }
+        auto [it, inserted] = write_times_.try_emplace(dir_entry.path(), write_time);
+        if (!inserted && it->second != write_time) {
+            it->second = write_time;
+            if (changed_files) { addChangedFile(*changed_files, dir_entry.path()); }
+        }
+    }
+}
+
+#endif
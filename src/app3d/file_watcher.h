@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+namespace app3d {
+
+class FileWatcher {
+ public:
+    FileWatcher() = default;
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool create(const std::filesystem::path& dir);
+
+    // Waits for modifications of files in watched directory tree and appends modified file names to the list
+    bool waitForChanges(std::chrono::milliseconds timeout, std::vector<std::filesystem::path>& changed_files);
+
+ private:
+#if defined(__linux__)
+    int fd_ = -1;
+    std::map<int, std::filesystem::path> watched_dirs_;
+
+    bool addWatch(const std::filesystem::path& dir);
+#else
+    std::filesystem::path dir_;
+    std::map<std::filesystem::path, std::filesystem::file_time_type> write_times_;
+
+    void scanWriteTimes(std::vector<std::filesystem::path>* changed_files);
+#endif
+};
+
+}  // namespace app3d
@@ -1,11 +1,15 @@
 #include "image_loader.h"
 #include "main_window.h"
 #include "model_loader.h"
+#include "render_queue.h"
+#include "shader_hot_reloader.h"
+#include "shader_variant_manager.h"
 
 #include "common/dynamic_library.h"
 #include "common/logger.h"
 #include "interfaces/i_rendering_driver.h"
 #include "rel/camera.h"
+#include "rel/shader_bundle.h"
 #include "util/range_helpers.h"
 
 #include <uxs/db/json.h>
@@ -15,7 +19,10 @@
 
 #include <array>
 #include <chrono>
+#include <cstring>
 #include <exception>
+#include <filesystem>
+#include <memory>
 #include <thread>
 
 using namespace app3d;
@@ -53,20 +60,21 @@ class Timer {
     double delta_ = 0.f;
 };
 
-template<typename Ty, std::size_t alignment = 256>
-struct Padded : public Ty {
-    std::uint8_t padding[((sizeof(Ty) + alignment - 1) & ~(alignment - 1)) - sizeof(Ty)];
-};
-
+// Instances share model rotation, their offsets are applied in world space
 struct CB0 {
     rel::Mat4f mvp;
+    rel::Mat4f vp;
     rel::Mat3f mv;
 };
 
+constexpr std::array INSTANCE_OFFSETS{rel::Vec3f{-1.f, 0.f, 0.f}, rel::Vec3f{1.f, 0.f, 0.f}};
+
 class App3DMainWindow final : public MainWindow {
  public:
     ~App3DMainWindow() {
+        if (hot_reloader_) { hot_reloader_->stop(); }  // background thread uses scene objects
         if (device_) { device_->waitDevice(); }
+        hot_reloader_.reset();  // retired pipelines can be used by frames in flight
     }
 
     int init(int argc, char** argv);
@@ -85,14 +93,23 @@ class App3DMainWindow final : public MainWindow {
         } else {
             const double delta = std::chrono::duration<double>(time_now - time_fps_last_).count();
             if (delta >= 2.) {
-                logInfo("fps = {:.1f}", frame_counter_ / delta);
+                const auto bind_statistics = render_target_->getBindStatistics();
+                logInfo("fps = {:.1f}, binds per frame: {} emitted, {} skipped", frame_counter_ / delta,
+                        bind_statistics.emitted_count, bind_statistics.skipped_count);
                 frame_counter_ = 0;
                 time_fps_last_ = time_now;
             }
         }
 
         timer_.update();
-        if (!renderScene()) { terminate(-1); }
+        bool is_frame_submitted = false;
+        if (!renderScene(is_frame_submitted)) { terminate(-1); }
+
+        // Rebuilt pipelines are swapped only between frames
+        if (hot_reloader_) {
+            if (is_frame_submitted) { hot_reloader_->onFrameSubmitted(); }
+            if (hot_reloader_->applyUpdates()) { pipeline_ = &hot_reloader_->getPipeline(shader_program_id_); }
+        }
         ++frame_counter_;
     }
 
@@ -153,6 +170,7 @@ class App3DMainWindow final : public MainWindow {
     bool is_window_minimized_ = false;
     bool is_window_sizing_or_moving_ = false;
     bool is_inverted_y_ndc_ = false;
+    bool use_bindless_ = false;
     rel::Extent2u viewport_extent_{};
 
     util::ref_ptr<rel::IRenderingDriver> driver_;
@@ -164,23 +182,31 @@ class App3DMainWindow final : public MainWindow {
     uxs::db::value swap_chain_opts_;
     util::ref_ptr<rel::ISwapChain> swap_chain_;
 
+    rel::ShaderBundle shader_bundle_;
+    std::unique_ptr<ShaderVariantManager> shader_variants_;
+    std::unique_ptr<ShaderHotReloader> hot_reloader_;
+    std::uint32_t shader_program_id_ = 0;
+
     util::ref_ptr<rel::IRenderTarget> render_target_;
     util::ref_ptr<rel::IShaderModule> vertex_shader_module_;
     util::ref_ptr<rel::IShaderModule> pixel_shader_module_;
     util::ref_ptr<rel::IPipelineLayout> pipeline_layout_;
     util::ref_ptr<rel::IPipeline> pipeline_;
+    util::ref_ptr<rel::IPipeline> ready_pipeline_;  // the last ready pipeline, used while `pipeline_` is compiled
     util::ref_ptr<rel::ITexture> texture_;
     util::ref_ptr<rel::ISampler> sampler_;
     util::ref_ptr<rel::IBuffer> vertex_buffer_;
+    util::ref_ptr<rel::IBuffer> instance_buffer_;
 
     struct FrameData {
         util::ref_ptr<rel::IDescriptorSet> descriptor_set;
         util::ref_ptr<rel::IBuffer> cbuffer0;
-        std::array<Padded<CB0>, 2> cb0;
+        CB0 cb0;
     };
 
     std::uint32_t n_frame_ = 0;
     uxs::inline_dynarray<FrameData, 3> frame_data_;
+    RenderQueue render_queue_;
 
     Image image_;
     Model model_;
@@ -197,14 +223,24 @@ class App3DMainWindow final : public MainWindow {
     }
 
     util::ref_ptr<rel::IShaderModule> compileShaderModule(const char* filename, const char* target);
+    util::ref_ptr<rel::IShaderModule> loadShaderModule(std::string_view name, const char* target);
     bool initScene();
-    void updateMatrices(Padded<CB0>* cb0);
-    bool renderScene();
+    void updateMatrices(CB0& cb0);
+    bool renderScene(bool& is_frame_submitted);
 };
 
 #define JSON(...) uxs::db::json::read_from_string(#__VA_ARGS__)
 
 int App3DMainWindow::init(int argc, char** argv) {
+    bool watch_shaders = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--watch-shaders") == 0) {
+            watch_shaders = true;
+        } else if (std::strcmp(argv[i], "--bindless") == 0) {
+            use_bindless_ = true;
+        }
+    }
+
     void* driver_library = loadDynamicLibrary(".", "app3d-rel-vulkan");
     if (!driver_library) { return -1; }
 
@@ -226,6 +262,7 @@ int App3DMainWindow::init(int argc, char** argv) {
     std::uint32_t device_count = driver_->getPhysicalDeviceCount();
 
     device_caps_ = JSON({"needs_compute" : true});
+    if (use_bindless_) { device_caps_["bindless"] = true; }
 
     for (device_index = 0; device_index < device_count; ++device_index) {
         logInfo("device #{}: {}", device_index, driver_->getPhysicalDeviceName(device_index));
@@ -243,12 +280,29 @@ int App3DMainWindow::init(int argc, char** argv) {
 
     if (!(swap_chain_ = device_->createSwapChain(*surface_, swap_chain_opts_))) { return -1; }
 
+    shader_variants_ = std::make_unique<ShaderVariantManager>(*driver_, *device_, std::thread::hardware_concurrency());
+
+    if (watch_shaders) {
+        hot_reloader_ = std::make_unique<ShaderHotReloader>([this](const ShaderHotReloader::StageDesc& stage) {
+            return compileShaderModule(stage.filename.string().c_str(), stage.target.c_str());
+        });
+    }
+
     if (!(render_target_ = swap_chain_->createRenderTarget(JSON({"use_depth" : true})))) { return -1; }
     is_inverted_y_ndc_ = render_target_->isInvertedNdcY();
     viewport_extent_ = render_target_->getImageExtent();
 
+    // Precompiled shaders are used if available, so shader compiler isn't loaded at all
+    if (const char* bundle_path = "data/shaders.bundle"; std::filesystem::exists(bundle_path)) {
+        if (shader_bundle_.open(bundle_path)) {
+            logInfo("using shader bundle with {} shaders", shader_bundle_.getShaderCount());
+        }
+    }
+
     if (!initScene()) { return -1; }
 
+    if (hot_reloader_ && !hot_reloader_->start("data/shaders", render_target_->getFifCount())) { return -1; }
+
     showWindow();
 
     timer_.resume();
@@ -282,46 +336,79 @@ util::ref_ptr<rel::IShaderModule> App3DMainWindow::compileShaderModule(const cha
     return nullptr;
 }
 
+util::ref_ptr<rel::IShaderModule> App3DMainWindow::loadShaderModule(std::string_view name, const char* target) {
+    if (shader_bundle_.isOpen()) {
+        // Bundle blobs are aligned, so modules are created right from the mapped file
+        if (const auto bytecode = shader_bundle_.findShader(name); !bytecode.empty()) {
+            return device_->createShaderModule(bytecode);
+        }
+        logWarning("shader '{}' is not found in bundle", name);
+    }
+
+    // Shaders are compiled only once, even if they are loaded several times
+    const std::uint32_t shader_id = shader_variants_->addShader({
+        .filename = uxs::format("data/shaders/{}.hlsl", name),
+        .target = target,
+    });
+    return shader_variants_->getVariant(shader_id, 0);
+}
+
 bool App3DMainWindow::initScene() {
-    vertex_shader_module_ = compileShaderModule("data/shaders/transform/vert.hlsl", "vs_6_0");
+    vertex_shader_module_ = loadShaderModule("transform/vert", "vs_6_0");
     if (!vertex_shader_module_) { return false; }
 
-    pixel_shader_module_ = compileShaderModule("data/shaders/transform/pix.hlsl", "ps_6_0");
+    // Bindless pixel shader takes the texture and the sampler by indices passed as push constants
+    const char* pixel_shader_name = use_bindless_ ? "bindless/pix" : "transform/pix";
+    pixel_shader_module_ = loadShaderModule(pixel_shader_name, "ps_6_0");
     if (!pixel_shader_module_) { return false; }
 
-    const auto pipeline_layout_config = JSON({
-        "descriptor_set_layouts" : [ {
-            "descriptor_list" : [
-                {"type" : "COMBINED_TEXTURE_SAMPLER", "shader_visibility" : "PIXEL"},  //
-                {"type" : "CONSTANT_BUFFER_DYNAMIC", "shader_visibility" : "VERTEX"}   //
-            ]
-        } ]
-    });
+    if (!(sampler_ = device_->createSampler(rel::SamplerDesc{
+              .filter = rel::SamplerFilter::MIN_MAG_LINEAR_MIP_POINT,
+              .address_mode_u = rel::SamplerAddressMode::REPEAT,
+              .address_mode_v = rel::SamplerAddressMode::REPEAT,
+          }))) {
+        return false;
+    }
+
+    // Descriptors are reflected from shaders, the sampler is baked into the layout, if bindless mode is off
+    const auto pipeline_layout_config =
+        use_bindless_ ? JSON({"bindless_set" : 1}) :
+                        JSON({"descriptor_overrides" : [ {"binding" : 0, "immutable_sampler" : 0} ]});
 
-    if (!(pipeline_layout_ = device_->createPipelineLayout(pipeline_layout_config))) { return false; }
+    if (!(pipeline_layout_ = device_->createPipelineLayout(
+              std::array{vertex_shader_module_.get(), pixel_shader_module_.get()}, pipeline_layout_config,
+              std::array{sampler_.get()}))) {
+        return false;
+    }
 
+    // Model vertices are taken from slot 0, instance offsets are taken from slot 1
     const auto pipeline_config = JSON({
-        "dynamic_primitive_topology" : true,
-        "dynamic_vertex_stride" : true,
-        "stages" : [
-            {"stage" : "VERTEX", "entry" : "main"},  //
-            {"stage" : "PIXEL", "entry" : "main"}    //
+        "vertex_layouts" : [
+            {"attributes" : [ {"format" : "FLOAT3"}, {"format" : "FLOAT3"}, {"format" : "FLOAT2"} ]},
+            {"input_rate" : "INSTANCE", "attributes" : [ {"location" : 3, "format" : "FLOAT3"} ]}
         ],
-        "vertex_layouts" : [ {
-            "attributes" : [
-                {"name" : "POSITION", "format" : "FLOAT3"},  //
-                {"name" : "NORMAL", "format" : "FLOAT3"},    //
-                {"name" : "TEXCOORD", "format" : "FLOAT2"}   //
-            ]
-        } ]
+        "dynamic_primitive_topology" : true,
+        "dynamic_vertex_stride" : true
     });
 
-    if (!(pipeline_ = device_->createPipeline(*render_target_, *pipeline_layout_,
-                                              std::array{vertex_shader_module_.get(), pixel_shader_module_.get()},
-                                              pipeline_config))) {
+    // Pipelines are compiled in background, frames are rendered with the previous pipeline until the new one is ready
+    const auto create_pipeline = [this, pipeline_config](std::span<rel::IShaderModule* const> shader_modules) {
+        return device_->createPipelineAsync(*render_target_, *pipeline_layout_, shader_modules, pipeline_config);
+    };
+
+    if (!(pipeline_ = create_pipeline(std::array{vertex_shader_module_.get(), pixel_shader_module_.get()}))) {
         return false;
     }
 
+    if (hot_reloader_) {
+        shader_program_id_ = hot_reloader_->addProgram(
+            {
+                {.filename = "data/shaders/transform/vert.hlsl", .target = "vs_6_0"},
+                {.filename = uxs::format("data/shaders/{}.hlsl", pixel_shader_name), .target = "ps_6_0"},
+            },
+            std::array{vertex_shader_module_.get(), pixel_shader_module_.get()}, create_pipeline, *pipeline_);
+    }
+
     if (!loadImageFromFile("data/images/sunset.jpg", image_, 4)) { return false; }
 
     const rel::TextureDesc texture_desc{
@@ -336,14 +423,6 @@ bool App3DMainWindow::initScene() {
         return false;
     }
 
-    if (!(sampler_ = device_->createSampler(rel::SamplerDesc{
-              .filter = rel::SamplerFilter::MIN_MAG_LINEAR_MIP_POINT,
-              .address_mode_u = rel::SamplerAddressMode::REPEAT,
-              .address_mode_v = rel::SamplerAddressMode::REPEAT,
-          }))) {
-        return false;
-    }
-
     frame_data_.resize(render_target_->getFifCount());
     if (frame_data_.empty()) {
         logError("bad render target");
@@ -353,8 +432,13 @@ bool App3DMainWindow::initScene() {
     for (auto& frame : frame_data_) {
         if (!(frame.descriptor_set = pipeline_layout_->createDescriptorSet(0))) { return false; }
         if (!(frame.cbuffer0 = device_->createBuffer(rel::BufferType::CONSTANT, sizeof(frame.cb0)))) { return false; }
-        frame.descriptor_set->updateCombinedTextureSamplerDescriptor(*texture_, *sampler_, 0, 0);
-        frame.descriptor_set->updateConstantBufferDescriptor(*frame.cbuffer0, 0, sizeof(frame.cb0[0]), 0);
+        const rel::DescriptorData cbuffer0_descriptor{.buffer = frame.cbuffer0.get(), .size = sizeof(frame.cb0)};
+        if (use_bindless_) {
+            frame.descriptor_set->updateDescriptors(std::array{cbuffer0_descriptor});
+        } else {
+            frame.descriptor_set->updateDescriptors(
+                std::array{rel::DescriptorData{.texture = texture_.get()}, cbuffer0_descriptor});
+        }
     }
 
     if (!loadModelFromObjFile("data/models/knot.obj",
@@ -369,28 +453,35 @@ bool App3DMainWindow::initScene() {
 
     if (!vertex_buffer_->updateBuffer(util::as_byte_span(model_.data), 0)) { return false; }
 
+    if (!(instance_buffer_ = device_->createBuffer(rel::BufferType::VERTEX, sizeof(INSTANCE_OFFSETS)))) {
+        return false;
+    }
+
+    if (!instance_buffer_->updateBuffer(util::as_byte_span(INSTANCE_OFFSETS), 0)) { return false; }
+
     return true;
 }
 
-void App3DMainWindow::updateMatrices(Padded<CB0>* cb0) {
+void App3DMainWindow::updateMatrices(CB0& cb0) {
     const auto r = rel::Mat4f::rotate(5.f * timer_.getCurrent(), {0.f, 1.f, 0.f});
-    const auto m1 = r * rel::Mat4f::translate({-1.f, 0.f, 0.f});
-    const auto m2 = r * rel::Mat4f::translate({1.f, 0.f, 0.f});
     const auto v = rel::Mat4f::lookAt(camera_.eye, camera_.center, camera_.up);
-    const auto mv1 = m1 * v;
-    const auto mv2 = m2 * v;
+    const auto mv = r * v;
     auto p = rel::Mat4f::perspective(float(viewport_extent_.width) / viewport_extent_.height, 50.0f, 0.5f, 50.0f);
     if (is_inverted_y_ndc_) { p.m[1][1] = -p.m[1][1]; }
-    cb0[0].mv = rel::Mat3f(mv1);
-    cb0[0].mvp = mv1 * p;
-    cb0[1].mv = rel::Mat3f(mv2);
-    cb0[1].mvp = mv2 * p;
+    cb0.mv = rel::Mat3f(mv);
+    cb0.mvp = mv * p;
+    cb0.vp = v * p;
 }
 
-bool App3DMainWindow::renderScene() {
+bool App3DMainWindow::renderScene(bool& is_frame_submitted) {
     auto& frame = frame_data_[n_frame_];
 
-    const auto result = render_target_->beginRenderTarget({0.1f, 0.2f, 0.3f, 1.0f}, 1.0f, 0, *pipeline_);
+    const auto pipeline_status = pipeline_->getStatus();
+    if (pipeline_status == rel::PipelineStatus::FAILED) { return false; }
+    if (pipeline_status == rel::PipelineStatus::READY) { ready_pipeline_ = pipeline_; }
+    if (!ready_pipeline_) { return true; }  // nothing to draw with yet
+
+    const auto result = render_target_->beginRenderTarget({0.1f, 0.2f, 0.3f, 1.0f}, 1.0f, 0, *ready_pipeline_);
     if (result == rel::RenderTargetResult::SUBOPTIMAL || result == rel::RenderTargetResult::OUT_OF_DATE) {
         if (!recreateSwapChain()) { return false; }
         if (result == rel::RenderTargetResult::OUT_OF_DATE) { return true; }
@@ -398,20 +489,40 @@ bool App3DMainWindow::renderScene() {
         return false;
     }
 
-    render_target_->bindVertexBuffer(*vertex_buffer_, 0, model_.vertex_stride, 0);
-
-    render_target_->setPrimitiveTopology(rel::PrimitiveTopology::TRIANGLES);
+    // Matrices are needed to sort the model by depth
+    updateMatrices(frame.cb0);
 
-    render_target_->bindDescriptorSetDynamic(*frame.descriptor_set, 0, std::array{std::uint32_t(0)});
-    for (const auto& part : model_.parts) { render_target_->drawGeometry(part.count, 1, part.offset, 0); }
+    if (use_bindless_) {
+        const std::array bindless_indices{texture_->getBindlessIndex(), sampler_->getBindlessIndex()};
+        render_target_->pushConstants(rel::ShaderStage::PIXEL_SHADER, 0, util::as_byte_span(bindless_indices));
+        render_target_->bindBindlessDescriptorSet();
+    }
 
-    render_target_->bindDescriptorSetDynamic(*frame.descriptor_set, 0, std::array{std::uint32_t(sizeof(frame.cb0[0]))});
-    for (const auto& part : model_.parts) { render_target_->drawGeometry(part.count, 1, part.offset, 0); }
+    // Instance offsets are taken from slot 1, which isn't touched by draw packets
+    render_target_->bindVertexBuffer(*instance_buffer_, 1, sizeof(rel::Vec3f), 0);
+
+    // Both copies of the model are drawn as instances, parts of the model are drawn as one batch
+    render_queue_.clear();
+    // W component of the transformed origin is its view depth
+    const std::uint64_t sort_key = RenderQueue::makeSortKey(0, 0, 0, frame.cb0.vp.m[3][3]);
+    rel::DrawPacket packet{
+        .vertex_buffer = vertex_buffer_.get(),
+        .vertex_stride = model_.vertex_stride,
+        .descriptor_set = frame.descriptor_set.get(),
+        .topology = rel::PrimitiveTopology::TRIANGLES,
+        .instance_count = std::uint32_t(INSTANCE_OFFSETS.size()),
+    };
+    for (const auto& part : model_.parts) {
+        packet.vertex_count = part.count;
+        packet.first_vertex = part.offset;
+        render_queue_.push(sort_key, packet);
+    }
+    render_queue_.submit(*render_target_);
 
-    updateMatrices(frame.cb0.data());
-    if (!frame.cbuffer0->updateBuffer(util::as_byte_span(std::span{frame.cb0}), 0)) { return false; }
+    if (!frame.cbuffer0->updateBuffer(util::as_byte_span(std::span{&frame.cb0, 1}), 0)) { return false; }
 
     if (!render_target_->endRenderTarget()) { return false; }
+    is_frame_submitted = true;
 
     if (++n_frame_ == frame_data_.size()) { n_frame_ = 0; }
     return true;
@@ -0,0 +1,78 @@
+#include "render_queue.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+using namespace app3d;
+
+namespace {
+// Keys are sorted by 8-bit digits starting from the least significant one
+constexpr unsigned DIGIT_BITS = 8;
+constexpr std::size_t DIGIT_COUNT = 64 / DIGIT_BITS;
+constexpr std::uint64_t DIGIT_MASK = (std::uint64_t(1) << DIGIT_BITS) - 1;
+}  // namespace
+
+// --------------------------------------------------------
+// RenderQueue class implementation
+
+std::uint64_t RenderQueue::makeSortKey(std::uint32_t pass, std::uint32_t pipeline_id, std::uint32_t material_id,
+                                       float depth) {
+    assert(pass < (1u << PASS_BITS));
+    assert(pipeline_id < (1u << PIPELINE_BITS));
+    assert(material_id < (1u << MATERIAL_BITS));
+    // Bit patterns of non-negative floats are ordered as their values
+    const std::uint32_t depth_bits = std::bit_cast<std::uint32_t>(depth > 0.f ? depth : 0.f);
+    return (std::uint64_t(pass) << (PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS)) |
+           (std::uint64_t(pipeline_id) << (MATERIAL_BITS + DEPTH_BITS)) | (std::uint64_t(material_id) << DEPTH_BITS) |
+           depth_bits;
+}
+
+void RenderQueue::clear() {
+    items_.clear();
+    packets_.clear();
+}
+
+void RenderQueue::push(std::uint64_t sort_key, const rel::DrawPacket& packet) {
+    items_.emplace_back(Item{.sort_key = sort_key, .packet_index = std::uint32_t(packets_.size())});
+    packets_.push_back(packet);
+}
+
+void RenderQueue::submit(rel::IRenderTarget& render_target) {
+    if (items_.empty()) { return; }
+
+    sortItems();
+
+    sorted_packets_.clear();
+    sorted_packets_.reserve(items_.size());
+    for (const auto& item : items_) { sorted_packets_.push_back(packets_[item.packet_index]); }
+
+    render_target.submitDrawPackets(sorted_packets_);
+}
+
+void RenderQueue::sortItems() {
+    // Histograms of all digits are counted in one pass over the keys
+    std::array<std::array<std::uint32_t, DIGIT_MASK + 1>, DIGIT_COUNT> histograms{};
+    for (const auto& item : items_) {
+        for (std::size_t n = 0; n < DIGIT_COUNT; ++n) {
+            ++histograms[n][(item.sort_key >> (n * DIGIT_BITS)) & DIGIT_MASK];
+        }
+    }
+
+    sorted_items_.resize(items_.size());
+    for (std::size_t n = 0; n < DIGIT_COUNT; ++n) {
+        const unsigned shift = unsigned(n * DIGIT_BITS);
+        auto& histogram = histograms[n];
+
+        // Most keys share high digits, such passes don't change the order
+        if (histogram[(items_[0].sort_key >> shift) & DIGIT_MASK] == items_.size()) { continue; }
+
+        std::uint32_t offset = 0;
+        for (auto& count : histogram) { offset += std::exchange(count, offset); }
+
+        // Items with equal digits keep their order, so the order of previous passes is preserved
+        for (const auto& item : items_) { sorted_items_[histogram[(item.sort_key >> shift) & DIGIT_MASK]++] = item; }
+        items_.swap(sorted_items_);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "interfaces/i_rendering_driver.h"
+
+#include <vector>
+
+namespace app3d {
+
+// Collects draws of a frame and submits them in order of their 64-bit sort keys. The key fields from the most
+// significant bits are: pass, pipeline, material and depth, so draws with the same state follow each other, and
+// opaque geometry with the same state is drawn front to back.
+class RenderQueue {
+ public:
+    static constexpr unsigned PASS_BITS = 4;
+    static constexpr unsigned PIPELINE_BITS = 12;
+    static constexpr unsigned MATERIAL_BITS = 16;
+    static constexpr unsigned DEPTH_BITS = 32;
+    static_assert(PASS_BITS + PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS == 64);
+
+    RenderQueue() = default;
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Negative depth is clamped to zero, draws of translucent passes should pass inverted depth to be drawn back to
+    // front
+    static std::uint64_t makeSortKey(std::uint32_t pass, std::uint32_t pipeline_id, std::uint32_t material_id,
+                                     float depth);
+
+    void clear();
+    void push(std::uint64_t sort_key, const rel::DrawPacket& packet);
+    // Sorts draws by keys and passes them to the render target, draws with equal keys are kept in order of pushing
+    void submit(rel::IRenderTarget& render_target);
+
+ private:
+    struct Item {
+        std::uint64_t sort_key;
+        std::uint32_t packet_index;
+    };
+
+    std::vector<Item> items_;
+    std::vector<Item> sorted_items_;
+    std::vector<rel::DrawPacket> packets_;
+    std::vector<rel::DrawPacket> sorted_packets_;
+
+    void sortItems();
+};
+
+}  // namespace app3d
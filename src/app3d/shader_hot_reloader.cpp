@@ -0,0 +1,130 @@
+#include "shader_hot_reloader.h"
+
+#include "common/logger.h"
+
+#include <algorithm>
+
+using namespace app3d;
+
+// --------------------------------------------------------
+// ShaderHotReloader class implementation
+
+ShaderHotReloader::~ShaderHotReloader() { stop(); }
+
+std::uint32_t ShaderHotReloader::addProgram(std::vector<StageDesc> stages, std::span<rel::IShaderModule* const> modules,
+                                            CreatePipelineFunc create_pipeline_func, rel::IPipeline& pipeline) {
+    assert(!thread_.joinable() && stages.size() == modules.size());
+    auto& program = programs_.emplace_back();
+    for (auto& stage : stages) { stage.filename = stage.filename.lexically_normal(); }
+    program.stages = std::move(stages);
+    program.create_pipeline_func = std::move(create_pipeline_func);
+    program.modules.assign(modules.begin(), modules.end());
+    program.pipeline = &pipeline;
+    return std::uint32_t(programs_.size() - 1);
+}
+
+bool ShaderHotReloader::start(const std::filesystem::path& dir, std::uint32_t fif_count) {
+    if (!watcher_.create(dir)) { return false; }
+    fif_count_ = fif_count;
+    thread_ = std::thread([this]() { run(); });
+    logInfo("watching shaders in '{}'", dir);
+    return true;
+}
+
+void ShaderHotReloader::stop() {
+    stop_ = true;
+    if (thread_.joinable()) { thread_.join(); }
+}
+
+void ShaderHotReloader::onFrameSubmitted() {
+    // Objects are released only when all frames in flight, which could use them, are finished: the frame submitted
+    // `fif_count` frames later has waited for them
+    std::erase_if(retired_programs_, [](auto& retired) { return --retired.frames_left == 0; });
+}
+
+bool ShaderHotReloader::applyUpdates() {
+    std::lock_guard lk(mtx_);
+
+    bool is_updated = false;
+    for (auto& program : programs_) {
+        if (!program.pending_pipeline) { continue; }
+
+        // Pipelines could be compiled asynchronously
+        const auto status = program.pending_pipeline->getStatus();
+        if (status == rel::PipelineStatus::PENDING) { continue; }
+        if (status == rel::PipelineStatus::FAILED) {
+            logError("couldn't rebuild pipeline, previous one is kept");
+            program.pending_modules.clear();
+            program.pending_pipeline.reset();
+            continue;
+        }
+
+        retired_programs_.emplace_back(RetiredProgram{
+            .modules = std::move(program.modules),
+            .pipeline = std::move(program.pipeline),
+            .frames_left = fif_count_,
+        });
+        program.modules = std::move(program.pending_modules);
+        program.pipeline = std::move(program.pending_pipeline);
+        is_updated = true;
+    }
+
+    return is_updated;
+}
+
+void ShaderHotReloader::run() {
+    std::vector<std::filesystem::path> changed_files;
+    while (!stop_) {
+        changed_files.clear();
+        if (!watcher_.waitForChanges(POLL_TIMEOUT, changed_files)) { break; }
+
+        // Editors usually emit several events for one save, so wait until things settle down
+        for (std::size_t count = 0; !stop_ && count != changed_files.size();) {
+            count = changed_files.size();
+            if (!watcher_.waitForChanges(DEBOUNCE_TIMEOUT, changed_files)) { return; }
+        }
+
+        if (!stop_ && !changed_files.empty()) { rebuildPrograms(changed_files); }
+    }
+}
+
+void ShaderHotReloader::rebuildPrograms(std::span<const std::filesystem::path> changed_files) {
+    for (auto& program : programs_) {
+        std::vector<util::ref_ptr<rel::IShaderModule>> modules;
+
+        {
+            std::lock_guard lk(mtx_);
+            modules = program.pending_pipeline ? program.pending_modules : program.modules;
+        }
+
+        bool is_affected = false;
+        bool is_failed = false;
+        for (std::size_t n = 0; n < program.stages.size() && !is_failed; ++n) {
+            const auto& stage = program.stages[n];
+            if (std::ranges::find(changed_files, stage.filename) == changed_files.end()) { continue; }
+            logInfo("recompiling shader '{}'", stage.filename);
+            is_affected = true;
+            if (auto module = compile_func_(stage)) {
+                modules[n] = std::move(module);
+            } else {
+                is_failed = true;
+            }
+        }
+
+        if (!is_affected || is_failed) { continue; }
+
+        std::vector<rel::IShaderModule*> module_ptrs;
+        module_ptrs.reserve(modules.size());
+        for (const auto& module : modules) { module_ptrs.push_back(module.get()); }
+
+        auto pipeline = program.create_pipeline_func(module_ptrs);
+        if (!pipeline) {
+            logError("couldn't rebuild pipeline, previous one is kept");
+            continue;
+        }
+
+        std::lock_guard lk(mtx_);
+        program.pending_modules = std::move(modules);
+        program.pending_pipeline = std::move(pipeline);
+    }
+}
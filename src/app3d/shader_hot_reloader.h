@@ -0,0 +1,76 @@
+#pragma once
+
+#include "file_watcher.h"
+
+#include "interfaces/i_rendering_driver.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace app3d {
+
+// Watches shader sources, recompiles changed shaders and rebuilds pipelines which use them on a background thread.
+// Rebuilt pipelines are swapped in by `applyUpdates`, which is to be called at a frame boundary.
+class ShaderHotReloader {
+ public:
+    struct StageDesc {
+        std::filesystem::path filename;
+        std::string target;
+    };
+
+    using CompileFunc = std::function<util::ref_ptr<rel::IShaderModule>(const StageDesc&)>;
+    using CreatePipelineFunc = std::function<util::ref_ptr<rel::IPipeline>(std::span<rel::IShaderModule* const>)>;
+
+    explicit ShaderHotReloader(CompileFunc compile_func) : compile_func_(std::move(compile_func)) {}
+    ~ShaderHotReloader();
+    ShaderHotReloader(const ShaderHotReloader&) = delete;
+    ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+    std::uint32_t addProgram(std::vector<StageDesc> stages, std::span<rel::IShaderModule* const> modules,
+                             CreatePipelineFunc create_pipeline_func, rel::IPipeline& pipeline);
+    bool start(const std::filesystem::path& dir, std::uint32_t fif_count);
+    // Stops the background thread, pipelines and modules are still kept
+    void stop();
+    // Must be called after each submitted frame, replaced objects are released after `fif_count` submitted frames
+    void onFrameSubmitted();
+    bool applyUpdates();
+
+    rel::IPipeline& getPipeline(std::uint32_t program_id) { return *programs_[program_id].pipeline; }
+
+ private:
+    struct Program {
+        std::vector<StageDesc> stages;
+        CreatePipelineFunc create_pipeline_func;
+        std::vector<util::ref_ptr<rel::IShaderModule>> modules;
+        util::ref_ptr<rel::IPipeline> pipeline;
+        std::vector<util::ref_ptr<rel::IShaderModule>> pending_modules;
+        util::ref_ptr<rel::IPipeline> pending_pipeline;
+    };
+
+    struct RetiredProgram {
+        std::vector<util::ref_ptr<rel::IShaderModule>> modules;
+        util::ref_ptr<rel::IPipeline> pipeline;
+        std::uint32_t frames_left;  // submitted frames, after which objects can be released
+    };
+
+    static constexpr std::chrono::milliseconds POLL_TIMEOUT{100};
+    static constexpr std::chrono::milliseconds DEBOUNCE_TIMEOUT{50};
+
+    CompileFunc compile_func_;
+    FileWatcher watcher_;
+    std::uint32_t fif_count_ = 0;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::mutex mtx_;
+    std::vector<Program> programs_;
+    std::vector<RetiredProgram> retired_programs_;
+
+    void run();
+    void rebuildPrograms(std::span<const std::filesystem::path> changed_files);
+};
+
+}  // namespace app3d
@@ -0,0 +1,139 @@
+#include "shader_variant_manager.h"
+
+#include "common/logger.h"
+
+#include <uxs/io/filebuf.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+using namespace app3d;
+
+// --------------------------------------------------------
+// ShaderVariantManager class implementation
+
+ShaderVariantManager::ShaderVariantManager(rel::IRenderingDriver& driver, rel::IDevice& device,
+                                           std::uint32_t thread_count)
+    : driver_(driver), device_(device), thread_count_(std::max(thread_count, 1u)) {}
+
+std::uint32_t ShaderVariantManager::addShader(ShaderDesc desc) {
+    assert(desc.keywords.size() <= MAX_KEYWORD_COUNT);
+    desc.filename = desc.filename.lexically_normal();
+    const auto it = std::ranges::find_if(shaders_, [&desc](const Shader& shader) {
+        return shader.desc.filename == desc.filename && shader.desc.target == desc.target &&
+               shader.desc.keywords == desc.keywords;
+    });
+    if (it != shaders_.end()) { return std::uint32_t(it - shaders_.begin()); }
+    shaders_.emplace_back().desc = std::move(desc);
+    return std::uint32_t(shaders_.size() - 1);
+}
+
+ShaderVariantManager::VariantKey ShaderVariantManager::makeVariantKey(
+    std::uint32_t shader_id, std::span<const std::string_view> enabled_keywords) const {
+    const auto& keywords = shaders_[shader_id].desc.keywords;
+    VariantKey key = 0;
+    for (const std::string_view keyword : enabled_keywords) {
+        const auto it = std::ranges::find(keywords, keyword);
+        if (it == keywords.end()) {
+            logWarning("unknown keyword '{}' of shader '{}'", keyword, shaders_[shader_id].desc.filename);
+            continue;
+        }
+        key |= VariantKey(1) << (it - keywords.begin());
+    }
+    return key;
+}
+
+bool ShaderVariantManager::compileVariants(std::span<const VariantRef> variants) {
+    // Sources are loaded and missing variants are collected on the calling thread
+    std::vector<VariantRef> missing_variants;
+    for (const auto& variant : variants) {
+        auto& shader = shaders_[variant.shader_id];
+        if (shader.variants.contains(variant.key) ||
+            std::ranges::any_of(missing_variants, [&variant](const VariantRef& missing_variant) {
+                return missing_variant.shader_id == variant.shader_id && missing_variant.key == variant.key;
+            })) {
+            continue;
+        }
+        if (!loadSourceText(shader)) { return false; }
+        missing_variants.push_back(variant);
+    }
+
+    if (missing_variants.empty()) { return true; }
+
+    std::vector<rel::DataBlob> binaries(missing_variants.size());
+    std::atomic<std::size_t> next_index{0};
+    const auto compile_variants = [this, &missing_variants, &binaries, &next_index]() {
+        for (std::size_t n = next_index++; n < missing_variants.size(); n = next_index++) {
+            binaries[n] = compileVariant(shaders_[missing_variants[n].shader_id], missing_variants[n].key);
+        }
+    };
+
+    // The calling thread compiles variants too
+    std::vector<std::thread> workers;
+    const std::size_t worker_count = std::min<std::size_t>(thread_count_, missing_variants.size()) - 1;
+    workers.reserve(worker_count);
+    for (std::size_t n = 0; n < worker_count; ++n) { workers.emplace_back(compile_variants); }
+    compile_variants();
+    for (auto& worker : workers) { worker.join(); }
+
+    bool is_compiled = true;
+    for (std::size_t n = 0; n < missing_variants.size(); ++n) {
+        if (binaries[n].isEmpty()) {
+            is_compiled = false;
+            continue;
+        }
+        auto shader_module = device_.createShaderModule(std::move(binaries[n]));
+        if (!shader_module) {
+            is_compiled = false;
+            continue;
+        }
+        shaders_[missing_variants[n].shader_id].variants.emplace(missing_variants[n].key, std::move(shader_module));
+    }
+
+    return is_compiled;
+}
+
+util::ref_ptr<rel::IShaderModule> ShaderVariantManager::getVariant(std::uint32_t shader_id, VariantKey key) {
+    auto& variants = shaders_[shader_id].variants;
+    if (auto it = variants.find(key); it != variants.end()) { return it->second; }
+    if (!compileVariants(std::array{VariantRef{.shader_id = shader_id, .key = key}})) { return nullptr; }
+    return variants[key];
+}
+
+bool ShaderVariantManager::loadSourceText(Shader& shader) {
+    if (!shader.source_text.isEmpty()) { return true; }
+    uxs::filebuf ifile(shader.desc.filename.c_str(), "r");
+    if (!ifile) {
+        logError("couldn't open '{}' shader file", shader.desc.filename);
+        return false;
+    }
+    shader.source_text = rel::DataBlob(ifile.seek(0, uxs::seekdir::end));
+    ifile.seek(0);
+    shader.source_text.truncate(ifile.read(shader.source_text.getTextBuffer()));
+    return true;
+}
+
+rel::DataBlob ShaderVariantManager::compileVariant(const Shader& shader, VariantKey key) {
+    uxs::db::value args;
+    args["filename"] = shader.desc.filename.string();
+    args["target"] = shader.desc.target;
+
+    // All keywords are defined, so shaders can test them with `#if`
+    auto& arg_list = args["args"];
+    for (std::size_t n = 0; n < shader.desc.keywords.size(); ++n) {
+        arg_list.emplace_back("-D");
+        arg_list.emplace_back(uxs::format("{}={}", shader.desc.keywords[n], (key >> n) & 1));
+    }
+
+    rel::DataBlob compiler_output;
+    auto shader_binary = driver_.compileShader(shader.source_text, args, compiler_output);
+    if (shader_binary.isEmpty()) {
+        logError("{}", compiler_output.getTextView());
+        return {};
+    }
+
+    if (!compiler_output.isEmpty()) { logWarning("{}", compiler_output.getTextView()); }
+    return shader_binary;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "interfaces/i_rendering_driver.h"
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace app3d {
+
+// Compiles permutations of HLSL shaders selected by feature keywords: each keyword of a shader is passed to the
+// compiler as `-D <keyword>=1` or `-D <keyword>=0`. Only requested variants are compiled, and compiled variants are
+// cached, so each one is compiled once.
+class ShaderVariantManager {
+ public:
+    struct ShaderDesc {
+        std::filesystem::path filename;
+        std::string target;
+        std::vector<std::string> keywords;
+    };
+
+    // Bit N of the key enables keyword N of the shader
+    using VariantKey = std::uint64_t;
+
+    struct VariantRef {
+        std::uint32_t shader_id;
+        VariantKey key;
+    };
+
+    static constexpr std::size_t MAX_KEYWORD_COUNT = 64;
+
+    ShaderVariantManager(rel::IRenderingDriver& driver, rel::IDevice& device, std::uint32_t thread_count);
+    ShaderVariantManager(const ShaderVariantManager&) = delete;
+    ShaderVariantManager& operator=(const ShaderVariantManager&) = delete;
+
+    // Returns the ID of already added shader, if it has the same file, target and keywords
+    std::uint32_t addShader(ShaderDesc desc);
+    // Unknown keywords are ignored with a warning
+    VariantKey makeVariantKey(std::uint32_t shader_id, std::span<const std::string_view> enabled_keywords) const;
+    // Compiles missing variants in parallel, returns `false` if any of them couldn't be compiled
+    bool compileVariants(std::span<const VariantRef> variants);
+    // Compiles the variant, if it isn't cached yet
+    util::ref_ptr<rel::IShaderModule> getVariant(std::uint32_t shader_id, VariantKey key);
+
+ private:
+    struct Shader {
+        ShaderDesc desc;
+        rel::DataBlob source_text;
+        std::unordered_map<VariantKey, util::ref_ptr<rel::IShaderModule>> variants;
+    };
+
+    rel::IRenderingDriver& driver_;
+    rel::IDevice& device_;
+    std::uint32_t thread_count_;
+    std::vector<Shader> shaders_;
+
+    bool loadSourceText(Shader& shader);
+    rel::DataBlob compileVariant(const Shader& shader, VariantKey key);
+};
+
+}  // namespace app3d
@@ -0,0 +1,92 @@
+#include "common/mapped_file.h"
+
+#include "common/logger.h"
+
+#if defined(WIN32)
+#    include <windows.h>  // NOLINT
+#elif defined(__linux__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using namespace app3d;
+
+bool MappedFile::open(const std::filesystem::path& file_path) {
+    close();
+
+#if defined(WIN32)
+    HANDLE file = ::CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        logError("couldn't open file '{}'", file_path);
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!::GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        logError("couldn't map empty file '{}'", file_path);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    mapping_ = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+    if (!mapping_) {
+        logError("couldn't create mapping of file '{}'", file_path);
+        return false;
+    }
+
+    data_ = static_cast<const std::uint8_t*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        logError("couldn't map file '{}'", file_path);
+        ::CloseHandle(mapping_);
+        mapping_ = nullptr;
+        return false;
+    }
+
+    size_ = std::size_t(file_size.QuadPart);
+#elif defined(__linux__)
+    const int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        logError("couldn't open file '{}'", file_path);
+        return false;
+    }
+
+    struct stat file_stat{};
+    if (::fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        logError("couldn't map empty file '{}'", file_path);
+        ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, std::size_t(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        logError("couldn't map file '{}'", file_path);
+        return false;
+    }
+
+    data_ = static_cast<const std::uint8_t*>(data);
+    size_ = std::size_t(file_stat.st_size);
+#else
+    logError("couldn't map file '{}': file mapping is not supported on this platform", file_path);
+    return false;
+#endif
+
+    return true;
+}
+
+void MappedFile::close() {
+    if (!data_) { return; }
+#if defined(WIN32)
+    ::UnmapViewOfFile(data_);
+    ::CloseHandle(mapping_);
+    mapping_ = nullptr;
+#elif defined(__linux__)
+    ::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
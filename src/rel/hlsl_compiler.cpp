@@ -9,6 +9,7 @@
 #include <uxs/string_util.h>
 
 #include <mutex>
+#include <vector>
 
 // clang-format off
 #ifdef _WIN32
@@ -33,23 +34,27 @@ class HlslCompiler::Implementation {
     void setPlatformArgs(uxs::db::basic_value<wchar_t> platform_args) { platform_args_ = std::move(platform_args); }
 
  private:
-    static std::atomic<bool> is_initialized_;
+    // Compiler objects aren't thread-safe, so each compiling thread takes its own instance
+    struct CompilerInstance {
+        util::ref_ptr<IDxcCompiler3> compiler;
+        util::ref_ptr<IDxcIncludeHandler> include_handler;
+    };
+
+    std::atomic<bool> is_initialized_{false};
     std::mutex mtx_;
     void* dxcompiler_library_ = nullptr;
     DxcCreateInstanceProc create_proc_ = nullptr;
     util::ref_ptr<IDxcUtils> dxc_utils_;
-    util::ref_ptr<IDxcCompiler3> dxc_compiler_;
-    util::ref_ptr<IDxcIncludeHandler> include_handler_;
+    std::vector<CompilerInstance> idle_instances_;
     uxs::db::basic_value<wchar_t> platform_args_;
 
     bool init();
+    bool obtainCompilerInstance(CompilerInstance& instance);
+    void releaseCompilerInstance(CompilerInstance instance);
 };
 
-std::atomic<bool> HlslCompiler::Implementation::is_initialized_{};
-
 HlslCompiler::Implementation::~Implementation() {
-    include_handler_.reset();
-    dxc_compiler_.reset();
+    idle_instances_.clear();
     dxc_utils_.reset();
     freeDynamicLibrary(dxcompiler_library_);
 }
@@ -57,6 +62,8 @@ HlslCompiler::Implementation::~Implementation() {
 bool HlslCompiler::Implementation::init() {
     std::lock_guard lk(mtx_);
 
+    if (is_initialized_) { return true; }
+
     if (!dxcompiler_library_) {
         dxcompiler_library_ = loadDynamicLibrary("", "dxcompiler");
         if (!dxcompiler_library_) { return false; }
@@ -74,13 +81,26 @@ bool HlslCompiler::Implementation::init() {
         return false;
     }
 
-    result = create_proc_(CLSID_DxcCompiler, IID_PPV_ARGS(dxc_compiler_.reset_and_get_address()));
+    is_initialized_ = true;
+    return true;
+}
+
+bool HlslCompiler::Implementation::obtainCompilerInstance(CompilerInstance& instance) {
+    std::lock_guard lk(mtx_);
+
+    if (!idle_instances_.empty()) {
+        instance = std::move(idle_instances_.back());
+        idle_instances_.pop_back();
+        return true;
+    }
+
+    HRESULT result = create_proc_(CLSID_DxcCompiler, IID_PPV_ARGS(instance.compiler.reset_and_get_address()));
     if (result != S_OK) {
         logError("couldn't create DxcCompiler3 object");
         return false;
     }
 
-    result = dxc_utils_->CreateDefaultIncludeHandler(include_handler_.reset_and_get_address());
+    result = dxc_utils_->CreateDefaultIncludeHandler(instance.include_handler.reset_and_get_address());
     if (result != S_OK) {
         logError("couldn't create DxcIncludeHandler object");
         return false;
@@ -89,6 +109,11 @@ bool HlslCompiler::Implementation::init() {
     return true;
 }
 
+void HlslCompiler::Implementation::releaseCompilerInstance(CompilerInstance instance) {
+    std::lock_guard lk(mtx_);
+    idle_instances_.push_back(std::move(instance));
+}
+
 DataBlob HlslCompiler::Implementation::compileShader(const DataBlob& source_text,
                                                      const uxs::db::basic_value<wchar_t>& args,
                                                      DataBlob& compiler_output) {
@@ -123,13 +148,14 @@ DataBlob HlslCompiler::Implementation::compileShader(const DataBlob& source_text
         .Encoding = DXC_CP_ACP,
     };
 
-    std::unique_lock lk(mtx_);
+    CompilerInstance instance;
+    if (!obtainCompilerInstance(instance)) { return {}; }
 
     util::ref_ptr<IDxcResult> results;
-    dxc_compiler_->Compile(&source, args_array.data(), UINT32(args_array.size()), &*include_handler_,
-                           IID_PPV_ARGS(results.reset_and_get_address()));
+    instance.compiler->Compile(&source, args_array.data(), UINT32(args_array.size()), &*instance.include_handler,
+                               IID_PPV_ARGS(results.reset_and_get_address()));
 
-    lk.unlock();
+    releaseCompilerInstance(std::move(instance));
 
     util::ref_ptr<IDxcBlobUtf8> errors;
     results->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(errors.reset_and_get_address()), nullptr);
@@ -167,6 +193,13 @@ HlslCompiler::HlslCompiler() : impl_(std::make_unique<Implementation>()) {}
 
 HlslCompiler::~HlslCompiler() {}
 
+uxs::db::value HlslCompiler::getSpirvPlatformArgs() {
+    uxs::db::value platform_args;
+    platform_args["args"] = uxs::db::value(
+        uxs::db::array_tag, {"-spirv", "-O3", "-Dbinding(n)=[[vk::binding(n)]]", "-Dlocation(n)=[[vk::location(n)]]"});
+    return platform_args;
+}
+
 namespace {
 uxs::db::basic_value<wchar_t> uft8ToWideUtfDbValue(const uxs::db::value& v) {
     return v.visit([](auto x) -> uxs::db::basic_value<wchar_t> {
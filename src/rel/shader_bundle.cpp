@@ -0,0 +1,121 @@
+#include "rel/shader_bundle.h"
+
+#include "common/logger.h"
+
+#include <uxs/io/filebuf.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace app3d;
+using namespace app3d::rel;
+
+// --------------------------------------------------------
+// ShaderBundle class implementation
+
+bool ShaderBundle::open(const std::filesystem::path& file_path) {
+    close();
+
+    if (!file_.open(file_path)) { return false; }
+
+    const auto fail = [this, &file_path](std::string_view reason) {
+        logError("bad shader bundle '{}': {}", file_path, reason);
+        close();
+        return false;
+    };
+
+    if (file_.getSize() < sizeof(Header)) { return fail("too short"); }
+
+    Header header;
+    std::memcpy(&header, file_.getData(), sizeof(Header));
+    if (header.magic != MAGIC) { return fail("invalid magic"); }
+    if (header.version != VERSION) { return fail("unsupported version"); }
+    if (file_.getSize() < sizeof(Header) + std::size_t(header.entry_count) * sizeof(Entry)) {
+        return fail("truncated index");
+    }
+
+    entries_ = std::span{reinterpret_cast<const Entry*>(file_.getData() + sizeof(Header)), header.entry_count};
+
+    for (const auto& entry : entries_) {
+        if (std::size_t(entry.name_offset) + entry.name_size > file_.getSize() ||
+            std::size_t(entry.data_offset) + entry.data_size > file_.getSize() || (entry.data_offset & 3) != 0) {
+            return fail("entry out of range");
+        }
+    }
+
+    return true;
+}
+
+void ShaderBundle::close() {
+    entries_ = {};
+    file_.close();
+}
+
+std::span<const std::uint8_t> ShaderBundle::findShader(std::string_view name) const {
+    auto it = std::ranges::lower_bound(entries_, name, {},
+                                       [this](const Entry& entry) { return getEntryName(entry); });
+    if (it == entries_.end() || getEntryName(*it) != name) { return {}; }
+    return std::span{file_.getData() + it->data_offset, it->data_size};
+}
+
+// --------------------------------------------------------
+// ShaderBundleWriter class implementation
+
+void ShaderBundleWriter::addShader(std::string name, DataBlob bytecode) {
+    shaders_.emplace_back(std::move(name), std::move(bytecode));
+}
+
+bool ShaderBundleWriter::write(const std::filesystem::path& file_path) {
+    std::ranges::sort(shaders_, {}, [](const auto& shader) { return std::string_view{shader.first}; });
+
+    const auto align_up = [](std::size_t v, std::size_t alignment) { return (v + alignment - 1) & ~(alignment - 1); };
+
+    std::size_t total_size = sizeof(ShaderBundle::Header) + shaders_.size() * sizeof(ShaderBundle::Entry);
+    for (const auto& [name, bytecode] : shaders_) { total_size += name.size(); }
+    for (const auto& [name, bytecode] : shaders_) { total_size = align_up(total_size, 8) + bytecode.getSize(); }
+
+    DataBlob bundle(total_size);
+    std::memset(bundle.getData(), 0, total_size);
+
+    const ShaderBundle::Header header{
+        .magic = ShaderBundle::MAGIC,
+        .version = ShaderBundle::VERSION,
+        .entry_count = std::uint32_t(shaders_.size()),
+    };
+
+    std::memcpy(bundle.getData(), &header, sizeof(header));
+
+    std::size_t name_offset = sizeof(ShaderBundle::Header) + shaders_.size() * sizeof(ShaderBundle::Entry);
+    std::size_t data_offset = name_offset;
+    for (const auto& [name, bytecode] : shaders_) { data_offset += name.size(); }
+
+    auto* entry = reinterpret_cast<ShaderBundle::Entry*>(bundle.getData() + sizeof(ShaderBundle::Header));
+    for (const auto& [name, bytecode] : shaders_) {
+        data_offset = align_up(data_offset, 8);
+        *entry++ = ShaderBundle::Entry{
+            .name_offset = std::uint32_t(name_offset),
+            .name_size = std::uint32_t(name.size()),
+            .data_offset = std::uint32_t(data_offset),
+            .data_size = std::uint32_t(bytecode.getSize()),
+        };
+        std::memcpy(bundle.getData() + name_offset, name.data(), name.size());
+        std::memcpy(bundle.getData() + data_offset, bytecode.getData(), bytecode.getSize());
+        name_offset += name.size();
+        data_offset += bytecode.getSize();
+    }
+
+    uxs::filebuf ofile(file_path.c_str(), "w");
+    if (!ofile) {
+        logError("couldn't create shader bundle '{}'", file_path);
+        return false;
+    }
+
+    ofile.write(bundle.getTextBuffer());
+    ofile.flush();
+    if (!ofile) {
+        logError("couldn't write shader bundle '{}'", file_path);
+        return false;
+    }
+
+    return true;
+}
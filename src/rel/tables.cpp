@@ -8,8 +8,19 @@ using namespace app3d::rel;
 
 namespace {
 const std::unordered_map<std::string_view, Format> g_formats{
-    {"FLOAT", Format::R32_FLOAT},           {"FLOAT2", Format::R32G32_FLOAT},  {"FLOAT3", Format::R32G32B32_FLOAT},
-    {"FLOAT4", Format::R32G32B32A32_FLOAT}, {"BYTE4", Format::R8G8B8A8_UNORM},
+    {"FLOAT", Format::R32_FLOAT},
+    {"FLOAT2", Format::R32G32_FLOAT},
+    {"FLOAT3", Format::R32G32B32_FLOAT},
+    {"FLOAT4", Format::R32G32B32A32_FLOAT},
+    {"BYTE4", Format::R8G8B8A8_UNORM},
+    {"INT", Format::R32_SINT},
+    {"INT2", Format::R32G32_SINT},
+    {"INT3", Format::R32G32B32_SINT},
+    {"INT4", Format::R32G32B32A32_SINT},
+    {"UINT", Format::R32_UINT},
+    {"UINT2", Format::R32G32_UINT},
+    {"UINT3", Format::R32G32B32_UINT},
+    {"UINT4", Format::R32G32B32A32_UINT},
 };
 const std::unordered_map<std::string_view, ShaderStage> g_shader_stages{
     {"ALL", ShaderStage::ALL_STAGES},
@@ -23,6 +34,16 @@ const std::unordered_map<std::string_view, PrimitiveTopology> g_primitive_topolo
     {"TRIANGLES", PrimitiveTopology::TRIANGLES},
     {"TRIANGLE_STRIP", PrimitiveTopology::TRIANGLE_STRIP},
 };
+const std::unordered_map<std::string_view, VertexInputRate> g_vertex_input_rates{
+    {"VERTEX", VertexInputRate::VERTEX},
+    {"INSTANCE", VertexInputRate::INSTANCE},
+};
+const std::unordered_map<std::string_view, ConstantType> g_constant_types{
+    {"BOOL", ConstantType::BOOL},
+    {"INT", ConstantType::INT},
+    {"UINT", ConstantType::UINT},
+    {"FLOAT", ConstantType::FLOAT},
+};
 const std::unordered_map<std::string_view, DescriptorType> g_descriptor_types{
     {"SAMPLER", DescriptorType::SAMPLER},
     {"COMBINED_TEXTURE_SAMPLER", DescriptorType::COMBINED_TEXTURE_SAMPLER},
@@ -39,6 +60,23 @@ const std::unordered_map<std::string_view, DescriptorType> g_descriptor_types{
     {"STRUCTURED_BUFFER_DYNAMIC", DescriptorType::STRUCTURED_BUFFER_DYNAMIC},
     {"RW_STRUCTURED_BUFFER_DYNAMIC", DescriptorType::RW_STRUCTURED_BUFFER_DYNAMIC},
 };
+const std::unordered_map<std::string_view, SamplerFilter> g_sampler_filters{
+    {"MIN_MAG_MIP_POINT", SamplerFilter::MIN_MAG_MIP_POINT},
+    {"MIN_MAG_POINT_MIP_LINEAR", SamplerFilter::MIN_MAG_POINT_MIP_LINEAR},
+    {"MIN_POINT_MAG_LINEAR_MIP_POINT", SamplerFilter::MIN_POINT_MAG_LINEAR_MIP_POINT},
+    {"MIN_POINT_MAG_MIP_LINEAR", SamplerFilter::MIN_POINT_MAG_MIP_LINEAR},
+    {"MIN_LINEAR_MAG_MIP_POINT", SamplerFilter::MIN_LINEAR_MAG_MIP_POINT},
+    {"MIN_LINEAR_MAG_POINT_MIP_LINEAR", SamplerFilter::MIN_LINEAR_MAG_POINT_MIP_LINEAR},
+    {"MIN_MAG_LINEAR_MIP_POINT", SamplerFilter::MIN_MAG_LINEAR_MIP_POINT},
+    {"MIN_MAG_MIP_LINEAR", SamplerFilter::MIN_MAG_MIP_LINEAR},
+    {"ANISOTROPIC", SamplerFilter::ANISOTROPIC},
+};
+const std::unordered_map<std::string_view, SamplerAddressMode> g_sampler_address_modes{
+    {"REPEAT", SamplerAddressMode::REPEAT},
+    {"MIRRORED_REPEAT", SamplerAddressMode::MIRRORED_REPEAT},
+    {"CLAMP_TO_EDGE", SamplerAddressMode::CLAMP_TO_EDGE},
+    {"MIRROR_CLAMP_TO_EDGE", SamplerAddressMode::MIRROR_CLAMP_TO_EDGE},
+};
 }  // namespace
 
 Format app3d::rel::parseFormat(std::string_view fmt) {
@@ -59,8 +97,32 @@ PrimitiveTopology app3d::rel::parsePrimitiveTopology(std::string_view topology)
     throw uxs::db::database_error("unknown primitive topology");
 }
 
+VertexInputRate app3d::rel::parseVertexInputRate(std::string_view input_rate) {
+    auto it = g_vertex_input_rates.find(input_rate);
+    if (it != g_vertex_input_rates.end()) { return it->second; }
+    throw uxs::db::database_error("unknown vertex input rate");
+}
+
+ConstantType app3d::rel::parseConstantType(std::string_view type) {
+    auto it = g_constant_types.find(type);
+    if (it != g_constant_types.end()) { return it->second; }
+    throw uxs::db::database_error("unknown constant type");
+}
+
 DescriptorType app3d::rel::parseDescriptorType(std::string_view type) {
     auto it = g_descriptor_types.find(type);
     if (it != g_descriptor_types.end()) { return it->second; }
     throw uxs::db::database_error("unknown descriptor type");
 }
+
+SamplerFilter app3d::rel::parseSamplerFilter(std::string_view filter) {
+    auto it = g_sampler_filters.find(filter);
+    if (it != g_sampler_filters.end()) { return it->second; }
+    throw uxs::db::database_error("unknown sampler filter");
+}
+
+SamplerAddressMode app3d::rel::parseSamplerAddressMode(std::string_view address_mode) {
+    auto it = g_sampler_address_modes.find(address_mode);
+    if (it != g_sampler_address_modes.end()) { return it->second; }
+    throw uxs::db::database_error("unknown sampler address mode");
+}
@@ -0,0 +1,121 @@
+#include "common/logger.h"
+#include "rel/hlsl_compiler.h"
+#include "rel/shader_bundle.h"
+
+#include <uxs/db/value.h>
+#include <uxs/io/filebuf.h>
+
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <string>
+
+using namespace app3d;
+
+namespace {
+
+bool loadShaderText(const std::filesystem::path& file_path, rel::DataBlob& shader_text) {
+    uxs::filebuf ifile(file_path.c_str(), "r");
+    if (!ifile) {
+        logError("couldn't open '{}' shader file", file_path);
+        return false;
+    }
+    shader_text = rel::DataBlob(ifile.seek(0, uxs::seekdir::end));
+    ifile.seek(0);
+    shader_text.truncate(ifile.read(shader_text.getTextBuffer()));
+    return true;
+}
+
+void printUsage() {
+    logInfo("usage: app3d-shader-bundler [-o <bundle>] [-t <file stem>=<profile>]... <shader dir>");
+    logInfo("  -o <bundle>                output bundle file name (default: shaders.bundle)");
+    logInfo("  -t <file stem>=<profile>   target profile for files with given stem (default: vert=vs_6_0, "
+            "pix=ps_6_0)");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        std::filesystem::path shader_dir;
+        std::filesystem::path output_path("shaders.bundle");
+        std::map<std::string, std::string, std::less<>> targets;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg(argv[i]);
+            if (arg == "-o" && i + 1 < argc) {
+                output_path = argv[++i];
+            } else if (arg == "-t" && i + 1 < argc) {
+                const std::string_view target(argv[++i]);
+                const auto pos = target.find('=');
+                if (pos == std::string_view::npos) {
+                    logError("invalid target '{}'", target);
+                    return -1;
+                }
+                targets.insert_or_assign(std::string(target.substr(0, pos)), std::string(target.substr(pos + 1)));
+            } else if (arg == "-h" || arg == "--help") {
+                printUsage();
+                return 0;
+            } else if (!arg.starts_with('-') && shader_dir.empty()) {
+                shader_dir = arg;
+            } else {
+                logError("invalid argument '{}'", arg);
+                printUsage();
+                return -1;
+            }
+        }
+
+        if (shader_dir.empty()) {
+            printUsage();
+            return -1;
+        }
+
+        if (targets.empty()) {
+            targets.emplace("vert", "vs_6_0");
+            targets.emplace("pix", "ps_6_0");
+        }
+
+        rel::HlslCompiler compiler;
+        compiler.setPlatformArgs(rel::HlslCompiler::getSpirvPlatformArgs());
+
+        rel::ShaderBundleWriter writer;
+
+        for (const auto& dir_entry : std::filesystem::recursive_directory_iterator(shader_dir)) {
+            const auto& file_path = dir_entry.path();
+            if (!dir_entry.is_regular_file() || file_path.extension() != ".hlsl") { continue; }
+
+            auto target_it = targets.find(file_path.stem().string());
+            if (target_it == targets.end()) {
+                logWarning("no target profile for '{}', skipping", file_path);
+                continue;
+            }
+
+            rel::DataBlob shader_text;
+            if (!loadShaderText(file_path, shader_text)) { return -1; }
+
+            const auto name = file_path.lexically_relative(shader_dir).replace_extension().generic_string();
+
+            uxs::db::value args;
+            args["filename"] = file_path.string();
+            args["target"] = target_it->second;
+
+            rel::DataBlob compiler_output;
+            auto shader_binary = compiler.compileShader(shader_text, args, compiler_output);
+            if (shader_binary.isEmpty()) {
+                logError("{}", compiler_output.getTextView());
+                return -1;
+            }
+
+            if (!compiler_output.isEmpty()) { logWarning("{}", compiler_output.getTextView()); }
+
+            logInfo("{} ({}): {} bytes", name, target_it->second, shader_binary.getSize());
+            writer.addShader(name, std::move(shader_binary));
+        }
+
+        return writer.write(output_path) ? 0 : -1;
+
+    } catch (const std::exception& e) {
+        logError("exception caught: {}", e.what());
+        return -1;
+    }
+}
@@ -0,0 +1,187 @@
+#include "bindless_descriptor_heap.h"
+
+#include "device.h"
+#include "vulkan_logger.h"
+
+#include "common/core_defs.h"
+
+using namespace app3d;
+using namespace app3d::rel;
+using namespace app3d::rel::vulkan;
+
+namespace {
+constexpr std::array TBL_VK_BINDLESS_DESC_TYPE{
+    // BindlessDescriptorHeap::ResourceType::
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,   // TEXTURE
+    VK_DESCRIPTOR_TYPE_SAMPLER,         // SAMPLER
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,  // BUFFER
+};
+}  // namespace
+
+// --------------------------------------------------------
+// BindlessDescriptorHeap class implementation
+
+bool BindlessDescriptorHeap::create(
+    Device& device, const std::array<std::uint32_t, unsigned(ResourceType::TOTAL_COUNT)>& capacities) {
+    device_ = &device;
+
+    std::array<VkDescriptorSetLayoutBinding, unsigned(ResourceType::TOTAL_COUNT)> bindings;
+    std::array<VkDescriptorBindingFlags, unsigned(ResourceType::TOTAL_COUNT)> binding_flags;
+    std::array<VkDescriptorPoolSize, unsigned(ResourceType::TOTAL_COUNT)> desc_counts;
+
+    for (std::uint32_t n = 0; n < std::uint32_t(ResourceType::TOTAL_COUNT); ++n) {
+        arrays_[n].capacity = capacities[n];
+        bindings[n] = VkDescriptorSetLayoutBinding{
+            .binding = n,
+            .descriptorType = TBL_VK_BINDLESS_DESC_TYPE[n],
+            .descriptorCount = capacities[n],
+            .stageFlags = VK_SHADER_STAGE_ALL,
+        };
+        binding_flags[n] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                           VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        desc_counts[n] = VkDescriptorPoolSize{
+            .type = TBL_VK_BINDLESS_DESC_TYPE[n],
+            .descriptorCount = capacities[n],
+        };
+    }
+
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = std::uint32_t(binding_flags.size()),
+        .pBindingFlags = binding_flags.data(),
+    };
+
+    const VkDescriptorSetLayoutCreateInfo create_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &binding_flags_create_info,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = std::uint32_t(bindings.size()),
+        .pBindings = bindings.data(),
+    };
+
+    VkResult result = device_->vkCreateDescriptorSetLayout(&create_info, nullptr, &set_layout_);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create layout for bindless descriptor set: {}", result);
+        return false;
+    }
+
+    const VkDescriptorPoolCreateInfo pool_create_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = std::uint32_t(desc_counts.size()),
+        .pPoolSizes = desc_counts.data(),
+    };
+
+    result = device_->vkCreateDescriptorPool(&pool_create_info, nullptr, &desc_pool_);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create bindless descriptor pool: {}", result);
+        return false;
+    }
+
+    const VkDescriptorSetAllocateInfo allocate_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = desc_pool_,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &set_layout_,
+    };
+
+    result = device_->vkAllocateDescriptorSets(&allocate_info, &desc_set_);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't allocate bindless descriptor set: {}", result);
+        return false;
+    }
+
+    logDebug(LOG_VK "bindless descriptor set for {} textures, {} samplers and {} buffers is created", capacities[0],
+             capacities[1], capacities[2]);
+    return true;
+}
+
+void BindlessDescriptorHeap::destroy() {
+    if (!device_) { return; }
+    device_->vkDestroyDescriptorPool(desc_pool_, nullptr);
+    device_->vkDestroyDescriptorSetLayout(set_layout_, nullptr);
+    device_ = nullptr;
+}
+
+std::uint32_t BindlessDescriptorHeap::addTexture(VkImageView image_view) {
+    const std::uint32_t index = allocateIndex(ResourceType::TEXTURE);
+    if (index == INVALID_UINT32_VALUE) { return INVALID_UINT32_VALUE; }
+    const VkDescriptorImageInfo image_info{
+        .imageView = image_view,
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+    device_->updateDescriptorSets(std::array{VkWriteDescriptorSet{
+                                      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                      .dstSet = desc_set_,
+                                      .dstBinding = std::uint32_t(ResourceType::TEXTURE),
+                                      .dstArrayElement = index,
+                                      .descriptorCount = 1,
+                                      .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                                      .pImageInfo = &image_info,
+                                  }},
+                                  {});
+    return index;
+}
+
+std::uint32_t BindlessDescriptorHeap::addSampler(VkSampler sampler) {
+    const std::uint32_t index = allocateIndex(ResourceType::SAMPLER);
+    if (index == INVALID_UINT32_VALUE) { return INVALID_UINT32_VALUE; }
+    const VkDescriptorImageInfo image_info{.sampler = sampler};
+    device_->updateDescriptorSets(std::array{VkWriteDescriptorSet{
+                                      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                      .dstSet = desc_set_,
+                                      .dstBinding = std::uint32_t(ResourceType::SAMPLER),
+                                      .dstArrayElement = index,
+                                      .descriptorCount = 1,
+                                      .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                                      .pImageInfo = &image_info,
+                                  }},
+                                  {});
+    return index;
+}
+
+std::uint32_t BindlessDescriptorHeap::addBuffer(VkBuffer buffer) {
+    const std::uint32_t index = allocateIndex(ResourceType::BUFFER);
+    if (index == INVALID_UINT32_VALUE) { return INVALID_UINT32_VALUE; }
+    const VkDescriptorBufferInfo buffer_info{.buffer = buffer, .offset = 0, .range = VK_WHOLE_SIZE};
+    device_->updateDescriptorSets(std::array{VkWriteDescriptorSet{
+                                      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                      .dstSet = desc_set_,
+                                      .dstBinding = std::uint32_t(ResourceType::BUFFER),
+                                      .dstArrayElement = index,
+                                      .descriptorCount = 1,
+                                      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                      .pBufferInfo = &buffer_info,
+                                  }},
+                                  {});
+    return index;
+}
+
+void BindlessDescriptorHeap::remove(ResourceType type, std::uint32_t index) {
+    if (index == INVALID_UINT32_VALUE) { return; }
+    // Partially bound descriptor doesn't need to be cleared: the index is just returned for reuse later
+    retired_indices_.emplace_back(RetiredIndex{.type = type, .index = index, .n_frame = device_->getFrameIndex()});
+}
+
+void BindlessDescriptorHeap::freeRetiredIndices() {
+    auto it = retired_indices_.begin();
+    for (; it != retired_indices_.end() && device_->isFrameFinished(it->n_frame); ++it) {
+        arrays_[unsigned(it->type)].free_indices.push_back(it->index);
+    }
+    retired_indices_.erase(retired_indices_.begin(), it);
+}
+
+std::uint32_t BindlessDescriptorHeap::allocateIndex(ResourceType type) {
+    auto& array = arrays_[unsigned(type)];
+    if (!array.free_indices.empty()) {
+        const std::uint32_t index = array.free_indices.back();
+        array.free_indices.pop_back();
+        return index;
+    }
+    if (array.count == array.capacity) {
+        logError(LOG_VK "bindless descriptor array is full: {} items", array.capacity);
+        return INVALID_UINT32_VALUE;
+    }
+    return array.count++;
+}
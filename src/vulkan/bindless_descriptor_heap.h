@@ -0,0 +1,67 @@
+#pragma once
+
+#include "vulkan_api.h"
+
+#include <array>
+#include <vector>
+
+namespace app3d::rel::vulkan {
+
+class Device;
+
+// Global update-after-bind descriptor set with runtime arrays of all textures, samplers and structured buffers:
+// shaders address resources by their stable indices in these arrays
+class BindlessDescriptorHeap {
+ public:
+    enum class ResourceType : std::uint32_t {
+        TEXTURE = 0,
+        SAMPLER,
+        BUFFER,
+        TOTAL_COUNT,
+    };
+
+    BindlessDescriptorHeap() = default;
+    BindlessDescriptorHeap(const BindlessDescriptorHeap&) = delete;
+    BindlessDescriptorHeap& operator=(const BindlessDescriptorHeap&) = delete;
+
+    bool isCreated() const { return device_ != nullptr; }
+
+    bool create(Device& device, const std::array<std::uint32_t, unsigned(ResourceType::TOTAL_COUNT)>& capacities);
+    void destroy();
+
+    VkDescriptorSetLayout getSetLayout() const { return set_layout_; }
+    VkDescriptorSet getDescriptorSet() const { return desc_set_; }
+
+    std::uint32_t addTexture(VkImageView image_view);
+    std::uint32_t addSampler(VkSampler sampler);
+    std::uint32_t addBuffer(VkBuffer buffer);
+    // Removed index isn't reused until frames in flight, which can still access it, are finished
+    void remove(ResourceType type, std::uint32_t index);
+    // Called by the device, when its frame is begun
+    void freeRetiredIndices();
+
+ private:
+    struct ResourceArray {
+        std::uint32_t capacity = 0;
+        std::uint32_t count = 0;
+        std::vector<std::uint32_t> free_indices;
+    };
+
+    Device* device_ = nullptr;
+    VkDescriptorSetLayout set_layout_{VK_NULL_HANDLE};
+    VkDescriptorPool desc_pool_{VK_NULL_HANDLE};
+    VkDescriptorSet desc_set_{VK_NULL_HANDLE};
+    std::array<ResourceArray, unsigned(ResourceType::TOTAL_COUNT)> arrays_;
+
+    struct RetiredIndex {
+        ResourceType type;
+        std::uint32_t index;
+        std::uint64_t n_frame;  // device frame, during which the index is removed
+    };
+
+    std::vector<RetiredIndex> retired_indices_;  // in order of removal
+
+    std::uint32_t allocateIndex(ResourceType type);
+};
+
+}  // namespace app3d::rel::vulkan
@@ -14,7 +14,12 @@ using namespace app3d::rel::vulkan;
 
 Buffer::Buffer(Device& device) : device_(util::not_null{&device}) {}
 
-Buffer::~Buffer() { vmaDestroyBuffer(device_->getAllocator(), buffer_, allocation_); }
+Buffer::~Buffer() {
+    if (bindless_index_ != INVALID_UINT32_VALUE) {
+        device_->getBindlessHeap().remove(BindlessDescriptorHeap::ResourceType::BUFFER, bindless_index_);
+    }
+    vmaDestroyBuffer(device_->getAllocator(), buffer_, allocation_);
+}
 
 bool Buffer::create(BufferType type, VkDeviceSize size) {
     if (type == BufferType::CONSTANT) {
@@ -23,10 +28,20 @@ bool Buffer::create(BufferType type, VkDeviceSize size) {
         size = (size + alignment_ - 1) & ~(alignment_ - 1);
     }
 
+    auto usage = VkBufferUsageFlags(TBL_VK_BUFFER_USAGE[unsigned(type)] | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    // Draw arguments can be written by compute shaders
+    if (type == BufferType::INDIRECT) { usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; }
+
+    // Descriptors of buffers stored in descriptor buffers refer to them by device addresses
+    if (type != BufferType::VERTEX && type != BufferType::INDEX && device_->useDescriptorBuffer()) {
+        usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    }
+
     const VkBufferCreateInfo create_info{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = size,
-        .usage = VkBufferUsageFlags(TBL_VK_BUFFER_USAGE[unsigned(type)] | VK_BUFFER_USAGE_TRANSFER_DST_BIT),
+        .usage = usage,
         .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
     };
 
@@ -40,6 +55,12 @@ bool Buffer::create(BufferType type, VkDeviceSize size) {
 
     type_ = type;
     size_ = size;
+
+    if (type == BufferType::STRUCTURED && device_->getBindlessHeap().isCreated()) {
+        bindless_index_ = device_->getBindlessHeap().addBuffer(buffer_);
+        if (bindless_index_ == INVALID_UINT32_VALUE) { return false; }
+    }
+
     return true;
 }
 
@@ -57,6 +78,23 @@ bool Buffer::updateBuffer(std::span<const std::uint8_t> data, std::uint64_t offs
                                          VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_NONE,
                                          VK_ACCESS_UNIFORM_READ_BIT, {});
         } break;
+        case BufferType::STRUCTURED: {
+            return device_->updateBuffer(
+                data, buffer_, VkDeviceSize(offset),
+                VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_NONE,
+                VK_ACCESS_SHADER_READ_BIT, {});
+        } break;
+        case BufferType::INDEX: {
+            return device_->updateBuffer(data, buffer_, VkDeviceSize(offset), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_NONE, VK_ACCESS_INDEX_READ_BIT,
+                                         {});
+        } break;
+        case BufferType::INDIRECT: {
+            return device_->updateBuffer(data, buffer_, VkDeviceSize(offset), VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_NONE,
+                                         VK_ACCESS_INDIRECT_COMMAND_READ_BIT, {});
+        } break;
         default: return false;
     }
 }
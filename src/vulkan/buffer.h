@@ -2,6 +2,7 @@
 
 #include "vulkan_api.h"
 
+#include "common/core_defs.h"
 #include "interfaces/i_rendering_driver.h"
 
 namespace app3d::rel::vulkan {
@@ -15,6 +16,10 @@ class Buffer : public util::ref_counter, public IBuffer {
 
     VkDeviceSize getSize() const { return size_; }
     VkDeviceSize getAlignment() const { return alignment_; }
+    // `VK_WHOLE_SIZE` range is resolved, because descriptors stored in descriptor buffers need explicit ranges
+    VkDeviceSize getRange(VkDeviceSize offset, VkDeviceSize size) const {
+        return size == VK_WHOLE_SIZE ? size_ - offset : size;
+    }
 
     bool create(BufferType type, VkDeviceSize size);
 
@@ -23,6 +28,7 @@ class Buffer : public util::ref_counter, public IBuffer {
     //@{ IBuffer
     util::ref_counter& getRefCounter() override { return *this; }
     bool updateBuffer(std::span<const std::uint8_t> data, std::uint64_t offset) override;
+    std::uint32_t getBindlessIndex() const override { return bindless_index_; }
     //@}
 
  private:
@@ -32,6 +38,7 @@ class Buffer : public util::ref_counter, public IBuffer {
     VkDeviceSize alignment_ = 1;
     VkBuffer buffer_{VK_NULL_HANDLE};
     VmaAllocation allocation_{VK_NULL_HANDLE};
+    std::uint32_t bindless_index_ = INVALID_UINT32_VALUE;
 };
 
 }  // namespace app3d::rel::vulkan
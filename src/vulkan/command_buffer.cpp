@@ -56,3 +56,18 @@ void CommandBuffer::beginRenderPass(VkRenderPass render_pass, VkFramebuffer fram
 
     vkCmdBeginRenderPass(&render_pass_begin_info, subpass_contents);
 }
+
+void CommandBuffer::beginRendering(VkRect2D render_area,
+                                   std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+                                   const VkRenderingAttachmentInfoKHR* depth_attachment) {
+    const VkRenderingInfoKHR rendering_info{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+        .renderArea = render_area,
+        .layerCount = 1,
+        .colorAttachmentCount = std::uint32_t(color_attachments.size()),
+        .pColorAttachments = color_attachments.data(),
+        .pDepthAttachment = depth_attachment,
+    };
+
+    vkCmdBeginRenderingKHR(&rendering_info);
+}
@@ -61,6 +61,14 @@ class CommandBuffer {
         vkCmdSetScissor(first_scissor, std::uint32_t(scissors.size()), scissors.data());
     }
 
+    void setViewportsWithCount(std::span<const VkViewport> viewports) {
+        vkCmdSetViewportWithCountEXT(std::uint32_t(viewports.size()), viewports.data());
+    }
+
+    void setScissorsWithCount(std::span<const VkRect2D> scissors) {
+        vkCmdSetScissorWithCountEXT(std::uint32_t(scissors.size()), scissors.data());
+    }
+
     void bindVertexBuffers(std::uint32_t first_binding, util::multispan<const VkBuffer, const VkDeviceSize> buffers) {
         vkCmdBindVertexBuffers(first_binding, std::uint32_t(buffers.size()), buffers.data<0>(), buffers.data<1>());
     }
@@ -79,10 +87,35 @@ class CommandBuffer {
                                 descriptor_sets.data(), std::uint32_t(dynamic_offsets.size()), dynamic_offsets.data());
     }
 
+    void pushConstants(VkPipelineLayout pipeline_layout, VkShaderStageFlags stage_flags, std::uint32_t offset,
+                       std::span<const std::uint8_t> data) {
+        vkCmdPushConstants(pipeline_layout, stage_flags, offset, std::uint32_t(data.size()), data.data());
+    }
+
+    void pushDescriptorSet(VkPipelineBindPoint pipeline_type, VkPipelineLayout pipeline_layout, std::uint32_t set_index,
+                           std::span<const VkWriteDescriptorSet> write_descriptors) {
+        vkCmdPushDescriptorSetKHR(pipeline_type, pipeline_layout, set_index, std::uint32_t(write_descriptors.size()),
+                                  write_descriptors.data());
+    }
+
+    void bindDescriptorBuffers(std::span<const VkDescriptorBufferBindingInfoEXT> binding_infos) {
+        vkCmdBindDescriptorBuffersEXT(std::uint32_t(binding_infos.size()), binding_infos.data());
+    }
+
+    void setDescriptorBufferOffsets(VkPipelineBindPoint pipeline_type, VkPipelineLayout pipeline_layout,
+                                    std::uint32_t first_set_index,
+                                    util::multispan<const std::uint32_t, const VkDeviceSize> offsets) {
+        vkCmdSetDescriptorBufferOffsetsEXT(pipeline_type, pipeline_layout, first_set_index,
+                                           std::uint32_t(offsets.size()), offsets.data<0>(), offsets.data<1>());
+    }
+
     void beginRenderPass(VkRenderPass render_pass, VkFramebuffer framebuffer, VkRect2D render_area,
                          VkSubpassContents subpass_contents, std::span<const VkClearValue> clear_values,
                          std::span<const VkImageView> attachments);
 
+    void beginRendering(VkRect2D render_area, std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+                        const VkRenderingAttachmentInfoKHR* depth_attachment);
+
     VkCommandBuffer getHandle() { return command_buffer_; }
 
  private:
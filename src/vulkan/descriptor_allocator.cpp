@@ -0,0 +1,149 @@
+#include "descriptor_allocator.h"
+
+#include "device.h"
+#include "vulkan_logger.h"
+
+#include <algorithm>
+
+using namespace app3d;
+using namespace app3d::rel;
+using namespace app3d::rel::vulkan;
+
+// --------------------------------------------------------
+// DescriptorAllocator class implementation
+
+void DescriptorAllocator::create(Device& device, VkDescriptorPoolCreateFlags flags, std::uint32_t max_sets,
+                                 std::span<const VkDescriptorPoolSize> desc_counts) {
+    device_ = &device;
+    flags_ = flags;
+    max_sets_ = max_sets;
+    desc_counts_.assign(desc_counts.begin(), desc_counts.end());
+}
+
+void DescriptorAllocator::destroy() {
+    if (!device_) { return; }
+    device_->flushDescriptorWrites();
+    for (const auto& pool : pools_) { device_->vkDestroyDescriptorPool(pool.handle, nullptr); }
+    pools_.clear();
+    retired_sets_.clear();
+    current_pool_ = 0;
+    device_ = nullptr;
+}
+
+bool DescriptorAllocator::allocate(VkDescriptorSetLayout set_layout,
+                                   std::span<const VkDescriptorPoolSize> set_desc_counts, Allocation& allocation) {
+    freeRetiredSets();
+    reserveDescCounts(set_desc_counts);
+
+    while (true) {
+        // Go to the next pool in chain or create a new one
+        if (current_pool_ == pools_.size()) {
+            const std::uint32_t shift = std::min(std::uint32_t(pools_.size()), 31u);
+            if (!createPool(std::min(1u << shift, MAX_POOL_SIZE_SCALE))) { return false; }
+        }
+
+        auto& pool = pools_[current_pool_];
+
+        const VkDescriptorSetAllocateInfo allocate_info{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = pool.handle,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &set_layout,
+        };
+
+        VkResult result = device_->vkAllocateDescriptorSets(&allocate_info, &allocation.handle);
+        if (result == VK_SUCCESS) {
+            ++pool.set_count;
+            allocation.pool_index = current_pool_;
+            allocation.pool_generation = pool.generation;
+            return true;
+        }
+
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            logError(LOG_VK "couldn't allocate descriptor sets: {}", result);
+            return false;
+        }
+
+        // The set, which doesn't fit into an empty pool of current sizes, won't fit into any next pool
+        if (pool.set_count == 0 && pool.desc_counts_revision == desc_counts_revision_) {
+            logError(LOG_VK "descriptor set doesn't fit into an empty descriptor pool");
+            return false;
+        }
+
+        ++current_pool_;
+    }
+}
+
+void DescriptorAllocator::free(const Allocation& allocation) {
+    assert(flags_ & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+    if (!isAllocationValid(allocation)) { return; }  // already reset
+    retired_sets_.emplace_back(RetiredSet{.allocation = allocation, .n_frame = device_->getFrameIndex()});
+    freeRetiredSets();
+}
+
+void DescriptorAllocator::reset() {
+    if (!device_) { return; }
+    device_->flushDescriptorWrites();
+    for (auto& pool : pools_) {
+        ++pool.generation;
+        if (pool.set_count == 0) { continue; }
+        device_->vkResetDescriptorPool(pool.handle, 0);
+        pool.set_count = 0;
+    }
+    retired_sets_.clear();  // freed together with pools
+    current_pool_ = 0;
+}
+
+bool DescriptorAllocator::createPool(std::uint32_t scale) {
+    uxs::inline_dynarray<VkDescriptorPoolSize> desc_counts(desc_counts_.begin(), desc_counts_.end());
+    for (auto& desc_count : desc_counts) { desc_count.descriptorCount *= scale; }
+
+    const VkDescriptorPoolCreateInfo create_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = flags_,
+        .maxSets = scale * max_sets_,
+        .poolSizeCount = std::uint32_t(desc_counts.size()),
+        .pPoolSizes = desc_counts.data(),
+    };
+
+    VkDescriptorPool desc_pool = VK_NULL_HANDLE;
+    VkResult result = device_->vkCreateDescriptorPool(&create_info, nullptr, &desc_pool);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create descriptor pool: {}", result);
+        return false;
+    }
+
+    auto& pool = pools_.emplace_back();
+    pool.handle = desc_pool;
+    pool.desc_counts_revision = desc_counts_revision_;
+    logDebug(LOG_VK "descriptor pool #{} for {} sets is created", pools_.size() - 1, create_info.maxSets);
+    return true;
+}
+
+void DescriptorAllocator::reserveDescCounts(std::span<const VkDescriptorPoolSize> set_desc_counts) {
+    for (const auto& set_desc_count : set_desc_counts) {
+        const std::uint32_t desc_count = max_sets_ * set_desc_count.descriptorCount;
+        auto it = std::ranges::find_if(desc_counts_, [type = set_desc_count.type](const auto& item) {
+            return item.type == type;
+        });
+        if (it == desc_counts_.end()) {
+            desc_counts_.emplace_back(VkDescriptorPoolSize{.type = set_desc_count.type, .descriptorCount = desc_count});
+            ++desc_counts_revision_;
+        } else if (it->descriptorCount < desc_count) {
+            it->descriptorCount = desc_count;
+            ++desc_counts_revision_;
+        }
+    }
+}
+
+void DescriptorAllocator::freeRetiredSets() {
+    if (retired_sets_.empty() || !device_->isFrameFinished(retired_sets_.front().n_frame)) { return; }
+    device_->flushDescriptorWrites();
+    auto it = retired_sets_.begin();
+    for (; it != retired_sets_.end() && device_->isFrameFinished(it->n_frame); ++it) {
+        auto& pool = pools_[it->allocation.pool_index];
+        device_->vkFreeDescriptorSets(pool.handle, 1, &it->allocation.handle);
+        --pool.set_count;
+    }
+    retired_sets_.erase(retired_sets_.begin(), it);
+}
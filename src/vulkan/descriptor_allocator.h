@@ -0,0 +1,76 @@
+#pragma once
+
+#include "vulkan_api.h"
+
+#include <uxs/dynarray.h>
+
+#include <span>
+#include <vector>
+
+namespace app3d::rel::vulkan {
+
+class Device;
+
+// Chain of descriptor pools: new pools are created on demand, when previous ones are exhausted; pool sizes are
+// given on creation and grow to fit sets of layouts passed to `allocate`
+class DescriptorAllocator {
+ public:
+    struct Allocation {
+        VkDescriptorSet handle;
+        std::uint32_t pool_index;
+        std::uint32_t pool_generation;
+    };
+
+    DescriptorAllocator() = default;
+    DescriptorAllocator(DescriptorAllocator&&) = default;
+    DescriptorAllocator& operator=(DescriptorAllocator&&) = default;
+
+    bool isCreated() const { return device_ != nullptr; }
+
+    void create(Device& device, VkDescriptorPoolCreateFlags flags, std::uint32_t max_sets,
+                std::span<const VkDescriptorPoolSize> desc_counts);
+    void destroy();
+
+    // `set_desc_counts` - descriptor counts of one set of the layout, new pools are made large enough for
+    // `max_sets` such sets
+    bool allocate(VkDescriptorSetLayout set_layout, std::span<const VkDescriptorPoolSize> set_desc_counts,
+                  Allocation& allocation);
+    // The set is freed, when frames in flight, which can still use it, are finished
+    void free(const Allocation& allocation);
+    void reset();
+    // Sets allocated before the reset of their pool are invalid
+    bool isAllocationValid(const Allocation& allocation) const {
+        return pools_[allocation.pool_index].generation == allocation.pool_generation;
+    }
+
+ private:
+    struct DescriptorPool {
+        VkDescriptorPool handle{VK_NULL_HANDLE};
+        std::uint32_t generation = 0;
+        std::uint32_t set_count = 0;
+        std::uint32_t desc_counts_revision = 0;  // revision of pool sizes the pool is created with
+    };
+
+    struct RetiredSet {
+        Allocation allocation;
+        std::uint64_t n_frame;  // device frame, during which the set is released
+    };
+
+    // Each next pool in chain is twice larger than previous one up to this limit
+    static constexpr std::uint32_t MAX_POOL_SIZE_SCALE = 16;
+
+    Device* device_ = nullptr;
+    VkDescriptorPoolCreateFlags flags_ = 0;
+    std::uint32_t max_sets_ = 0;
+    uxs::inline_dynarray<VkDescriptorPoolSize> desc_counts_;
+    std::uint32_t desc_counts_revision_ = 0;
+    uxs::inline_dynarray<DescriptorPool, 4> pools_;
+    std::uint32_t current_pool_ = 0;
+    std::vector<RetiredSet> retired_sets_;  // in order of release
+
+    bool createPool(std::uint32_t scale);
+    void reserveDescCounts(std::span<const VkDescriptorPoolSize> set_desc_counts);
+    void freeRetiredSets();
+};
+
+}  // namespace app3d::rel::vulkan
@@ -0,0 +1,81 @@
+#include "descriptor_buffer.h"
+
+#include "device.h"
+#include "rendering_driver.h"
+#include "vulkan_logger.h"
+#include "wrappers.h"
+
+#include <cstring>
+
+using namespace app3d;
+using namespace app3d::rel;
+using namespace app3d::rel::vulkan;
+
+namespace {
+// Sets with samplers and sets with other resources are placed into the same buffer
+constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                       VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                       VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+}  // namespace
+
+// --------------------------------------------------------
+// DescriptorBuffer class implementation
+
+bool DescriptorBuffer::create(Device& device, VkDeviceSize size) {
+    const VkBufferCreateInfo create_info{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = DESCRIPTOR_BUFFER_USAGE,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+
+    VmaAllocationInfo allocation_info{};
+    VkResult result = vmaCreateBuffer(device.getAllocator(), &create_info,
+                                      constAddressOf(VmaAllocationCreateInfo{
+                                          .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                                                   VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                          .usage = VMA_MEMORY_USAGE_AUTO,
+                                          .requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      }),
+                                      &buffer_, &allocation_, &allocation_info);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create descriptor buffer: {}", result);
+        return false;
+    }
+
+    device_ = &device;
+    mapped_data_ = static_cast<std::uint8_t*>(allocation_info.pMappedData);
+    address_ = device.getBufferDeviceAddress(buffer_);
+    size_ = size;
+    used_size_ = 0;
+    alignment_ = device.getPhysicalDevice().getDescriptorBufferProperties().descriptorBufferOffsetAlignment;
+    return true;
+}
+
+void DescriptorBuffer::destroy() {
+    if (!device_) { return; }
+    vmaDestroyBuffer(device_->getAllocator(), buffer_, allocation_);
+    buffer_ = VK_NULL_HANDLE;
+    allocation_ = VK_NULL_HANDLE;
+    mapped_data_ = nullptr;
+    device_ = nullptr;
+}
+
+VkDescriptorBufferBindingInfoEXT DescriptorBuffer::getBindingInfo() const {
+    return VkDescriptorBufferBindingInfoEXT{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+        .address = address_,
+        .usage = DESCRIPTOR_BUFFER_USAGE,
+    };
+}
+
+VkDeviceSize DescriptorBuffer::append(std::span<const std::uint8_t> desc_data) {
+    const VkDeviceSize offset = (used_size_ + alignment_ - 1) & ~(alignment_ - 1);
+    if (offset + desc_data.size() > size_) {
+        logError(LOG_VK "descriptor buffer of {} bytes is exhausted", size_);
+        return VK_WHOLE_SIZE;
+    }
+    std::memcpy(mapped_data_ + offset, desc_data.data(), desc_data.size());
+    used_size_ = offset + desc_data.size();
+    return offset;
+}
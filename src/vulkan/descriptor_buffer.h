@@ -0,0 +1,41 @@
+#pragma once
+
+#include "vulkan_api.h"
+
+#include <span>
+
+namespace app3d::rel::vulkan {
+
+class Device;
+
+// Host visible buffer with descriptor data of sets bound during a frame: contents of descriptor sets are
+// linearly appended to it on binding and the buffer is reset, when the frame is finished
+class DescriptorBuffer {
+ public:
+    DescriptorBuffer() = default;
+    DescriptorBuffer(const DescriptorBuffer&) = delete;
+    DescriptorBuffer& operator=(const DescriptorBuffer&) = delete;
+
+    bool isCreated() const { return device_ != nullptr; }
+
+    bool create(Device& device, VkDeviceSize size);
+    void destroy();
+
+    VkDescriptorBufferBindingInfoEXT getBindingInfo() const;
+
+    // Returns `VK_WHOLE_SIZE`, if the buffer is exhausted
+    VkDeviceSize append(std::span<const std::uint8_t> desc_data);
+    void reset() { used_size_ = 0; }
+
+ private:
+    Device* device_ = nullptr;
+    VkBuffer buffer_{VK_NULL_HANDLE};
+    VmaAllocation allocation_{VK_NULL_HANDLE};
+    std::uint8_t* mapped_data_ = nullptr;
+    VkDeviceAddress address_ = 0;
+    VkDeviceSize size_ = 0;
+    VkDeviceSize used_size_ = 0;
+    VkDeviceSize alignment_ = 1;
+};
+
+}  // namespace app3d::rel::vulkan
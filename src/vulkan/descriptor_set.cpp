@@ -4,6 +4,7 @@
 #include "sampler.h"
 #include "tables.h"
 #include "texture.h"
+#include "vulkan_logger.h"
 
 using namespace app3d;
 using namespace app3d::rel;
@@ -15,13 +16,72 @@ using namespace app3d::rel::vulkan;
 DescriptorSet::DescriptorSet(Device& device, PipelineLayout& pipeline_layout)
     : device_(util::not_null{&device}), pipeline_layout_(util::not_null{&pipeline_layout}) {}
 
-DescriptorSet::~DescriptorSet() {}
+DescriptorSet::~DescriptorSet() {
+    if (pipeline_layout_) { pipeline_layout_->releaseDescriptorSet(handle_); }
+}
+
+bool DescriptorSet::create(std::uint32_t set_layout_index) {
+    if (!pipeline_layout_->obtainDescriptorSet(set_layout_index, handle_)) { return false; }
+    allocateDescriptorData();
+    return true;
+}
+
+void DescriptorSet::assignTransient(PipelineLayout& pipeline_layout,
+                                    const PipelineLayout::DescriptorSetHandle& handle) {
+    pipeline_layout_ = &pipeline_layout;
+    handle_ = handle;
+    allocateDescriptorData();
+}
+
+void DescriptorSet::releaseTransient() {
+    pipeline_layout_.reset();
+    handle_ = PipelineLayout::DescriptorSetHandle{};
+}
+
+bool DescriptorSet::update(std::span<const DescriptorData> descriptors) {
+    const auto& update_template = pipeline_layout_->getUpdateTemplate(handle_.set_layout_index);
+    if (update_template.has_texel_buffers) {
+        logError(LOG_VK "descriptor set can't be updated at once: layout has texel buffers");
+        return false;
+    }
+    if (descriptors.size() != update_template.desc_types.size()) {
+        logError(LOG_VK "descriptor set update has {} descriptors, but layout has {}", descriptors.size(),
+                 update_template.desc_types.size());
+        return false;
+    }
+
+    uxs::inline_dynarray<PipelineLayout::DescriptorInfo, 32> desc_infos(descriptors.size());
+    PipelineLayout::makeDescriptorInfos(update_template, descriptors, desc_infos);
+
+    if (device_->useDescriptorBuffer()) {
+        for (std::size_t n = 0; n < update_template.entries.size(); ++n) {
+            const auto& entry = update_template.entries[n];
+            const std::size_t desc_size = device_->getDescriptorSize(entry.descriptorType);
+            const auto* desc_info = &desc_infos[entry.offset / sizeof(PipelineLayout::DescriptorInfo)];
+            std::uint8_t* desc = desc_data_.data() + update_template.desc_buffer_offsets[n];
+            for (std::uint32_t i = 0; i < entry.descriptorCount; ++i, desc += desc_size) {
+                writeDescriptorData(entry.descriptorType, desc_info[i], desc);
+            }
+        }
+        desc_data_version_ = device_->makeDescriptorDataVersion();
+        return true;
+    }
+
+    if (update_template.handle == VK_NULL_HANDLE) { return true; }  // empty set
+
+    device_->updateDescriptorSetWithTemplate(handle_.handle, update_template.handle, desc_infos.data());
+    return true;
+}
 
 //@{ IDescriptorSet
 
+void DescriptorSet::updateDescriptors(std::span<const DescriptorData> descriptors) { update(descriptors); }
+
 void DescriptorSet::updateSamplerDescriptor(ISampler& sampler, std::uint32_t slot) {
     const auto& binding_offsets = *handle_.binding_offsets;
-    writeImageDescriptorSet(pipeline_layout_->getBinding(binding_offsets, BindingType::SAMPLER, slot),
+    const auto& binding = pipeline_layout_->getBinding(binding_offsets, BindingType::SAMPLER, slot);
+    if (binding.has_immutable_sampler) { return; }  // sampler descriptors with immutable samplers are never written
+    writeImageDescriptorSet(binding,
                             std::array{VkDescriptorImageInfo{.sampler = static_cast<Sampler&>(sampler).getHandle()}});
 }
 
@@ -31,7 +91,22 @@ void DescriptorSet::updateCombinedTextureSamplerDescriptor(ITexture& texture, IS
     const auto& binding = pipeline_layout_->getBinding(binding_offsets, BindingType::SHADER_RESOURCE, slot);
     assert(pipeline_layout_->getBinding(binding_offsets, BindingType::SAMPLER, slot).binding == binding.binding);
     writeImageDescriptorSet(binding, std::array{VkDescriptorImageInfo{
-                                         .sampler = static_cast<Sampler&>(sampler).getHandle(),
+                                         .sampler = binding.has_immutable_sampler ?
+                                                        VK_NULL_HANDLE :
+                                                        static_cast<Sampler&>(sampler).getHandle(),
+                                         .imageView = static_cast<Texture&>(texture).getImageView(0),
+                                         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                     }});
+}
+
+void DescriptorSet::updateCombinedTextureSamplerDescriptor(ITexture& texture, std::uint32_t slot) {
+    const auto& binding_offsets = *handle_.binding_offsets;
+    const auto& binding = pipeline_layout_->getBinding(binding_offsets, BindingType::SHADER_RESOURCE, slot);
+    if (!binding.has_immutable_sampler) {
+        logError(LOG_VK "sampler must be specified for binding {} without immutable sampler", binding.binding);
+        return;
+    }
+    writeImageDescriptorSet(binding, std::array{VkDescriptorImageInfo{
                                          .imageView = static_cast<Texture&>(texture).getImageView(0),
                                          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                                      }});
@@ -53,14 +128,52 @@ void DescriptorSet::updateConstantBufferDescriptor(IBuffer& buffer, std::uint64_
                              std::array{VkDescriptorBufferInfo{
                                  .buffer = static_cast<Buffer&>(buffer).getHandle(),
                                  .offset = VkDeviceSize(offset),
-                                 .range = VkDeviceSize(size),
+                                 .range = static_cast<Buffer&>(buffer).getRange(offset, size),
                              }});
 }
 
 //@}
 
+void DescriptorSet::allocateDescriptorData() {
+    if (!device_->useDescriptorBuffer()) { return; }
+    const auto& update_template = pipeline_layout_->getUpdateTemplate(handle_.set_layout_index);
+    desc_data_.assign(std::size_t(update_template.desc_buffer_size), 0);
+    desc_data_version_ = device_->makeDescriptorDataVersion();
+}
+
+std::uint8_t* DescriptorSet::getDescriptorData(PipelineLayout::Binding binding) {
+    const auto& update_template = pipeline_layout_->getUpdateTemplate(handle_.set_layout_index);
+    const auto& entries = update_template.entries;
+    const auto entry_it = std::ranges::find_if(
+        entries, [&binding](const auto& entry) { return entry.dstBinding == binding.binding; });
+    assert(entry_it != entries.end());
+    return desc_data_.data() + update_template.desc_buffer_offsets[entry_it - entries.begin()] +
+           binding.array_element * device_->getDescriptorSize(entry_it->descriptorType);
+}
+
+void DescriptorSet::writeDescriptorData(VkDescriptorType vk_type, const PipelineLayout::DescriptorInfo& desc_info,
+                                        std::uint8_t* desc) {
+    if (vk_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || vk_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+        device_->getBufferDescriptor(vk_type, desc_info.buffer, desc);
+    } else {
+        device_->getImageDescriptor(vk_type, desc_info.image, desc);
+    }
+}
+
 void DescriptorSet::writeImageDescriptorSet(PipelineLayout::Binding binding,
                                             std::span<const VkDescriptorImageInfo> image_infos) {
+    if (device_->useDescriptorBuffer()) {
+        const auto vk_type = TBL_VK_DESC_TYPE[unsigned(binding.desc_type)];
+        const std::size_t desc_size = device_->getDescriptorSize(vk_type);
+        std::uint8_t* desc = getDescriptorData(binding);
+        for (const auto& image_info : image_infos) {
+            device_->getImageDescriptor(vk_type, image_info, desc);
+            desc += desc_size;
+        }
+        desc_data_version_ = device_->makeDescriptorDataVersion();
+        return;
+    }
+
     device_->updateDescriptorSets(
         std::array{
             VkWriteDescriptorSet{
@@ -78,6 +191,18 @@ void DescriptorSet::writeImageDescriptorSet(PipelineLayout::Binding binding,
 
 void DescriptorSet::writeBufferDescriptorSet(PipelineLayout::Binding binding,
                                              std::span<const VkDescriptorBufferInfo> buffer_infos) {
+    if (device_->useDescriptorBuffer()) {
+        const auto vk_type = TBL_VK_DESC_TYPE[unsigned(binding.desc_type)];
+        const std::size_t desc_size = device_->getDescriptorSize(vk_type);
+        std::uint8_t* desc = getDescriptorData(binding);
+        for (const auto& buffer_info : buffer_infos) {
+            device_->getBufferDescriptor(vk_type, buffer_info, desc);
+            desc += desc_size;
+        }
+        desc_data_version_ = device_->makeDescriptorDataVersion();
+        return;
+    }
+
     device_->updateDescriptorSets(
         std::array{
             VkWriteDescriptorSet{
@@ -2,6 +2,8 @@
 
 #include "pipeline_layout.h"
 
+#include <vector>
+
 namespace app3d::rel::vulkan {
 
 class Device;
@@ -11,18 +13,26 @@ class DescriptorSet final : public util::ref_counter, public IDescriptorSet {
     DescriptorSet(Device& device, PipelineLayout& pipeline_layout);
     ~DescriptorSet() override;
 
-    bool create(std::uint32_t set_layout_index) {
-        return pipeline_layout_->obtainDescriptorSet(set_layout_index, handle_);
-    }
+    bool create(std::uint32_t set_layout_index);
+    void assignTransient(PipelineLayout& pipeline_layout, const PipelineLayout::DescriptorSetHandle& handle);
+    // Pooled transient set object doesn't keep the layout, when its frame is reset
+    void releaseTransient();
+    bool update(std::span<const DescriptorData> descriptors);
+    bool isValid() const { return pipeline_layout_->isDescriptorSetValid(handle_); }
 
     VkDescriptorSet getHandle() { return handle_.handle; }
+    std::span<const std::uint8_t> getDescriptorData() const { return desc_data_; }
+    // Changes on each update of descriptor data
+    std::uint64_t getDescriptorDataVersion() const { return desc_data_version_; }
     PipelineLayout& getLayout() { return *pipeline_layout_; }
 
     //@{ IDescriptorSet
     util::ref_counter& getRefCounter() override { return *this; }
+    void updateDescriptors(std::span<const DescriptorData> descriptors) override;
     void updateSamplerDescriptor(ISampler&, std::uint32_t slot) override;
     void updateCombinedTextureSamplerDescriptor(ITexture& texture, ISampler& sampler, std::uint32_t slot,
                                                 std::uint32_t sampler_slot) override;
+    void updateCombinedTextureSamplerDescriptor(ITexture& texture, std::uint32_t slot) override;
     void updateShaderResourceDescriptor(ITexture& texture, std::uint32_t slot) override;
     void updateConstantBufferDescriptor(IBuffer& buffer, std::uint64_t offset, std::uint64_t size,
                                         std::uint32_t slot) override;
@@ -30,9 +40,15 @@ class DescriptorSet final : public util::ref_counter, public IDescriptorSet {
 
  private:
     util::ref_ptr<Device> device_;
-    util::ref_ptr<PipelineLayout> pipeline_layout_;
+    util::ref_ptr<PipelineLayout> pipeline_layout_;  // null for released transient set
     PipelineLayout::DescriptorSetHandle handle_{};
+    std::vector<std::uint8_t> desc_data_;  // contents of the set in descriptor buffer mode
+    std::uint64_t desc_data_version_ = 0;
 
+    void allocateDescriptorData();
+    std::uint8_t* getDescriptorData(PipelineLayout::Binding binding);
+    void writeDescriptorData(VkDescriptorType vk_type, const PipelineLayout::DescriptorInfo& desc_info,
+                             std::uint8_t* desc);
     void writeImageDescriptorSet(PipelineLayout::Binding binding, std::span<const VkDescriptorImageInfo> image_infos);
     void writeBufferDescriptorSet(PipelineLayout::Binding binding, std::span<const VkDescriptorBufferInfo> buffer_infos);
 };
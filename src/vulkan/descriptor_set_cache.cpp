@@ -0,0 +1,76 @@
+#include "descriptor_set_cache.h"
+
+#include "device.h"
+
+#include <functional>
+
+using namespace app3d;
+using namespace app3d::rel;
+using namespace app3d::rel::vulkan;
+
+// --------------------------------------------------------
+// DescriptorSetCache class implementation
+
+DescriptorSetCache::DescriptorSetCache(Device& device, PipelineLayout& pipeline_layout,
+                                       std::uint32_t max_unused_frames)
+    : device_(util::not_null{&device}), pipeline_layout_(util::not_null{&pipeline_layout}),
+      max_unused_frames_(max_unused_frames) {}
+
+std::size_t DescriptorSetCache::KeyHash::operator()(const Key& key) const {
+    std::size_t hash = key.set_layout_index;
+    for (const std::uint64_t word : key.content) {
+        hash ^= std::hash<std::uint64_t>{}(word) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+//@{ IDescriptorSetCache
+
+IDescriptorSet* DescriptorSetCache::obtainDescriptorSet(std::uint32_t set_layout_index,
+                                                        std::span<const DescriptorData> descriptors) {
+    Key key{.set_layout_index = set_layout_index};
+    key.content.reserve(5 * descriptors.size());
+    for (const auto& data : descriptors) {
+        key.content.push_back(reinterpret_cast<std::uintptr_t>(data.texture));
+        key.content.push_back(reinterpret_cast<std::uintptr_t>(data.sampler));
+        key.content.push_back(reinterpret_cast<std::uintptr_t>(data.buffer));
+        key.content.push_back(data.offset);
+        key.content.push_back(data.size);
+    }
+
+    if (auto it = entries_.find(key); it != entries_.end()) {
+        if (it->second->descriptor_set->isValid()) {
+            lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+            it->second->last_used_frame = n_frame_;
+            return it->second->descriptor_set.get();
+        }
+        // The set is lost with descriptor allocator reset
+        lru_list_.erase(it->second);
+        entries_.erase(it);
+    }
+
+    auto descriptor_set = util::make_new<DescriptorSet>(*device_, *pipeline_layout_);
+    if (!descriptor_set->create(set_layout_index) || !descriptor_set->update(descriptors)) { return nullptr; }
+
+    auto& entry = lru_list_.emplace_front();
+    entry.descriptor_set = std::move(descriptor_set);
+    entry.last_used_frame = n_frame_;
+    for (const auto& data : descriptors) {
+        if (data.texture) { entry.resources.emplace_back(&data.texture->getRefCounter()); }
+        if (data.sampler) { entry.resources.emplace_back(&data.sampler->getRefCounter()); }
+        if (data.buffer) { entry.resources.emplace_back(&data.buffer->getRefCounter()); }
+    }
+
+    entry.key = &entries_.emplace(std::move(key), lru_list_.begin()).first->first;
+    return entry.descriptor_set.get();
+}
+
+void DescriptorSetCache::nextFrame() {
+    ++n_frame_;
+    while (!lru_list_.empty() && n_frame_ - lru_list_.back().last_used_frame > max_unused_frames_) {
+        entries_.erase(*lru_list_.back().key);
+        lru_list_.pop_back();
+    }
+}
+
+//@}
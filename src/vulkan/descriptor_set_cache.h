@@ -0,0 +1,57 @@
+#pragma once
+
+#include "descriptor_set.h"
+
+#include <uxs/dynarray.h>
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
+namespace app3d::rel::vulkan {
+
+class Device;
+
+// Descriptor sets addressed by their content: referenced resources are kept alive while the set is cached, so the
+// same content can't be taken by new objects; sets lost with descriptor allocator reset are recreated on demand
+class DescriptorSetCache final : public util::ref_counter, public IDescriptorSetCache {
+ public:
+    DescriptorSetCache(Device& device, PipelineLayout& pipeline_layout, std::uint32_t max_unused_frames);
+    ~DescriptorSetCache() override = default;
+
+    //@{ IDescriptorSetCache
+    util::ref_counter& getRefCounter() override { return *this; }
+    IDescriptorSet* obtainDescriptorSet(std::uint32_t set_layout_index,
+                                        std::span<const DescriptorData> descriptors) override;
+    void nextFrame() override;
+    //@}
+
+ private:
+    struct Key {
+        std::uint32_t set_layout_index;
+        uxs::inline_dynarray<std::uint64_t, 16> content;
+        bool operator==(const Key& other) const {
+            return set_layout_index == other.set_layout_index && std::ranges::equal(content, other.content);
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        const Key* key;
+        util::ref_ptr<DescriptorSet> descriptor_set;
+        uxs::inline_dynarray<util::ref_ptr<util::ref_counter>, 8> resources;
+        std::uint64_t last_used_frame;
+    };
+
+    util::ref_ptr<Device> device_;
+    util::ref_ptr<PipelineLayout> pipeline_layout_;
+    std::uint32_t max_unused_frames_;
+    std::uint64_t n_frame_ = 0;
+    std::list<Entry> lru_list_;  // the most recently used entry goes first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+};
+
+}  // namespace app3d::rel::vulkan
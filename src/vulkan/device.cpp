@@ -8,12 +8,18 @@
 #include "shader_module.h"
 #include "surface.h"
 #include "swap_chain.h"
+#include "tables.h"
 #include "texture.h"
 #include "vulkan_logger.h"
 #include "wrappers.h"
 
 #include "rel/tables.h"
 
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <thread>
+
 using namespace app3d;
 using namespace app3d::rel;
 using namespace app3d::rel::vulkan;
@@ -25,6 +31,7 @@ Device::Device(RenderingDriver& instance, PhysicalDevice& physical_device)
     : instance_(util::not_null(&instance)), physical_device_(physical_device) {}
 
 Device::~Device() {
+    pipeline_compiler_.destroy();
     for (auto& kit : transfer_kits_) {
         waitForFences(std::array{kit.fence}, VK_FALSE, FINISH_TRANSFER_TIMEOUT);
         vmaDestroyBuffer(allocator_, kit.staging_buffer.handle, kit.staging_buffer.allocation);
@@ -33,18 +40,86 @@ Device::~Device() {
     graphics_queue_.destroy();
     compute_queue_.destroy();
     transfer_queue_.destroy();
+    bindless_heap_.destroy();
     for (auto* surface : instance_->getSurfaces()) { surface->getPresentQueue().destroy(); }
     vmaDestroyAllocator(allocator_);
     vkDestroyDevice(nullptr);
 }
 
 bool Device::create(const uxs::db::value& caps) {
-    std::vector<const char*> device_extensions;
+    auto& device_extensions = enabled_extensions_;
     device_extensions.reserve(32);
     device_extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     device_extensions.push_back(VK_KHR_IMAGELESS_FRAMEBUFFER_EXTENSION_NAME);
     device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
 
+    const bool use_bindless = caps.value<bool>("bindless");
+    if (use_bindless) {
+        if (!physical_device_.isBindlessSupported()) {
+            logError(LOG_VK "bindless descriptors are not supported");
+            return false;
+        }
+        device_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    }
+
+    use_descriptor_buffer_ = caps.value<bool>("descriptor_buffer");
+    if (use_descriptor_buffer_) {
+        if (use_bindless) {
+            logError(LOG_VK "bindless mode can't be used together with descriptor buffers");
+            return false;
+        }
+        if (!physical_device_.isDescriptorBufferSupported()) {
+            logError(LOG_VK "descriptor buffers are not supported");
+            return false;
+        }
+        device_extensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        descriptor_buffer_size_ = caps.value_or<VkDeviceSize>("descriptor_buffer_size",
+                                                              DEFAULT_DESCRIPTOR_BUFFER_SIZE);
+    }
+
+    // Shader objects are bound instead of pipelines, all the state is set dynamically
+    use_shader_object_ = caps.value<bool>("shader_object");
+    if (use_shader_object_) {
+        if (!physical_device_.isShaderObjectSupported()) {
+            logError(LOG_VK "shader objects are not supported");
+            return false;
+        }
+        device_extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        device_extensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+    }
+
+    // Pipelines are built of separately compiled libraries, if it's requested, supported and linking is fast
+    use_graphics_pipeline_library_ = !use_shader_object_ && caps.value<bool>("graphics_pipeline_library") &&
+                                     physical_device_.isGraphicsPipelineLibrarySupported() &&
+                                     physical_device_.getGraphicsPipelineLibraryProperties()
+                                         .graphicsPipelineLibraryFastLinking;
+    if (use_graphics_pipeline_library_) {
+        device_extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        device_extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+
+    // Extended dynamic state 2 and 3 let one pipeline serve several fixed-function state variants
+    if (physical_device_.isExtensionSupported(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+        device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+    }
+    if (physical_device_.isExtensionSupported(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+        device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    }
+
+    // Instance data can advance once per several instances
+    if (physical_device_.isExtensionSupported(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME)) {
+        device_extensions.push_back(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME);
+    }
+
+    // Batches of draws with the same state are recorded as one command
+    use_multi_draw_ = caps.value_or<bool>("multi_draw", true) && physical_device_.isMultiDrawSupported();
+    if (use_multi_draw_) { device_extensions.push_back(VK_EXT_MULTI_DRAW_EXTENSION_NAME); }
+
+    // One core is left for the main thread, workers are started on the first asynchronous pipeline
+    pipeline_compiler_.create(caps.value_or<std::uint32_t>(
+        "pipeline_compile_thread_count",
+        std::clamp(std::thread::hardware_concurrency(), 2u, MAX_DEFAULT_PIPELINE_COMPILE_THREAD_COUNT + 1) - 1));
+
     const char* portability_subset_extension_name = "VK_KHR_portability_subset";
     if (physical_device_.isExtensionSupported(portability_subset_extension_name)) {
         device_extensions.push_back("VK_KHR_portability_subset");
@@ -57,6 +132,11 @@ bool Device::create(const uxs::db::value& caps) {
         }
     }
 
+    // Functionality of optional extensions is turned off, if they are not supported
+    for (const char* extension : OPTIONAL_DEVICE_EXTENSIONS) {
+        if (physical_device_.isExtensionSupported(extension)) { device_extensions.push_back(extension); }
+    }
+
     VkPhysicalDeviceImagelessFramebufferFeatures imageless_framebuffer_features{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES,
         .imagelessFramebuffer = VK_TRUE,
@@ -68,9 +148,96 @@ bool Device::create(const uxs::db::value& caps) {
         .extendedDynamicState = VK_TRUE,
     };
 
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptor_indexing_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+        .shaderStorageBufferArrayNonUniformIndexing = VK_TRUE,
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+        .descriptorBindingPartiallyBound = VK_TRUE,
+        .runtimeDescriptorArray = VK_TRUE,
+    };
+
+    VkPhysicalDeviceBufferDeviceAddressFeatures buffer_device_address_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES,
+        .bufferDeviceAddress = VK_TRUE,
+    };
+
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+        .descriptorBuffer = VK_TRUE,
+    };
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+        .graphicsPipelineLibrary = VK_TRUE,
+    };
+
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT,
+        .extendedDynamicState2 = physical_device_.getExtendedDynamicState2Features().extendedDynamicState2,
+    };
+
+    const auto& supported_dynamic_state3_features = physical_device_.getExtendedDynamicState3Features();
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state3_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+        .extendedDynamicState3PolygonMode = supported_dynamic_state3_features.extendedDynamicState3PolygonMode,
+        .extendedDynamicState3ColorBlendEnable =
+            supported_dynamic_state3_features.extendedDynamicState3ColorBlendEnable,
+        .extendedDynamicState3ColorBlendEquation =
+            supported_dynamic_state3_features.extendedDynamicState3ColorBlendEquation,
+    };
+
+    const auto& supported_divisor_features = physical_device_.getVertexAttributeDivisorFeatures();
+    VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT vertex_attribute_divisor_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_FEATURES_EXT,
+        .vertexAttributeInstanceRateDivisor = supported_divisor_features.vertexAttributeInstanceRateDivisor,
+        .vertexAttributeInstanceRateZeroDivisor = supported_divisor_features.vertexAttributeInstanceRateZeroDivisor,
+    };
+
+    VkPhysicalDeviceMultiDrawFeaturesEXT multi_draw_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT,
+        .multiDraw = VK_TRUE,
+    };
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+        .dynamicRendering = VK_TRUE,
+    };
+
+    VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+        .shaderObject = VK_TRUE,
+    };
+
+    // Features of optional functionality are chained only if it is used
+    void* feature_chain = &dynamic_state_features;
+    const auto chain_features = [&feature_chain](auto& features) {
+        features.pNext = feature_chain;
+        feature_chain = &features;
+    };
+
+    if (use_bindless) { chain_features(descriptor_indexing_features); }
+    if (use_descriptor_buffer_) {
+        chain_features(buffer_device_address_features);
+        chain_features(descriptor_buffer_features);
+    }
+    if (use_graphics_pipeline_library_) { chain_features(graphics_pipeline_library_features); }
+    if (isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) { chain_features(dynamic_state2_features); }
+    if (isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) { chain_features(dynamic_state3_features); }
+    if (use_shader_object_) {
+        chain_features(dynamic_rendering_features);
+        chain_features(shader_object_features);
+    }
+    if (isExtensionEnabled(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME)) {
+        chain_features(vertex_attribute_divisor_features);
+    }
+    if (use_multi_draw_) { chain_features(multi_draw_features); }
+
     VkPhysicalDeviceFeatures2 features2{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-        .pNext = &dynamic_state_features,
+        .pNext = feature_chain,
         .features = physical_device_.getFeatures(),
     };
 
@@ -161,12 +328,6 @@ bool Device::create(const uxs::db::value& caps) {
         return false;
     }
 
-    const auto is_extension_enabled = [&device_extensions](const char* extension) {
-        return std::ranges::any_of(device_extensions, [extension](const char* enabled_extension) {
-            return std::string_view(extension) == std::string_view(enabled_extension);
-        });
-    };
-
 #define DEVICE_LEVEL_VK_FUNCTION(name) \
     vk_funcs_.name = (PFN_##name)instance_->getVkFuncs().vkGetDeviceProcAddr(device_, #name); \
     if (!vk_funcs_.name) { \
@@ -175,15 +336,14 @@ bool Device::create(const uxs::db::value& caps) {
     }
 
 #define DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(name, extension) \
-    if (is_extension_enabled(extension)) { \
+    if (hasExtensionFunctions(extension)) { \
         vk_funcs_.name = (PFN_##name)instance_->getVkFuncs().vkGetDeviceProcAddr(device_, #name); \
         if (!vk_funcs_.name) { \
             logError(LOG_VK "couldn't obtain device-level Vulkan function '{}'", #name); \
             return false; \
         } \
     } else { \
-        logError(LOG_VK "device extension '{}' is not enabled", extension); \
-        return false; \
+        vk_funcs_.name = nullptr; \
     }
 
 #define DEVICE_LEVEL_VK_FUNCTION_QUEUE(name) DEVICE_LEVEL_VK_FUNCTION(name)
@@ -200,7 +360,8 @@ bool Device::create(const uxs::db::value& caps) {
     };
 
     const VmaAllocatorCreateInfo allocator_create_info{
-        .flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT,
+        .flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT |
+                 (use_descriptor_buffer_ ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : 0u),
         .physicalDevice = physical_device_.getHandle(),
         .device = device_,
         .pVulkanFunctions = &vulkan_functions,
@@ -227,9 +388,71 @@ bool Device::create(const uxs::db::value& caps) {
         if (!createFence(true, transfer_kits_[n].fence)) { return false; }
     }
 
+    if (use_bindless) {
+        const auto& props = physical_device_.getDescriptorIndexingProperties();
+        const std::uint32_t texture_count = caps.value_or<std::uint32_t>("bindless_texture_count",
+                                                                         DEFAULT_BINDLESS_TEXTURE_COUNT);
+        const std::uint32_t sampler_count = caps.value_or<std::uint32_t>("bindless_sampler_count",
+                                                                         DEFAULT_BINDLESS_SAMPLER_COUNT);
+        const std::uint32_t buffer_count = caps.value_or<std::uint32_t>("bindless_buffer_count",
+                                                                        DEFAULT_BINDLESS_BUFFER_COUNT);
+        const std::array capacities{
+            std::min(texture_count, props.maxPerStageDescriptorUpdateAfterBindSampledImages),
+            std::min(sampler_count, props.maxPerStageDescriptorUpdateAfterBindSamplers),
+            std::min(buffer_count, props.maxPerStageDescriptorUpdateAfterBindStorageBuffers),
+        };
+        if (!bindless_heap_.create(*this, capacities)) { return false; }
+    }
+
     return true;
 }
 
+bool Device::isExtensionEnabled(std::string_view extension) const {
+    return std::ranges::any_of(enabled_extensions_,
+                               [extension](const char* enabled_extension) { return extension == enabled_extension; });
+}
+
+bool Device::isDynamicStateSupported(VkDynamicState state) const {
+    // All the state is dynamic with shader objects
+    if (use_shader_object_) { return true; }
+    const auto& dynamic_state3_features = physical_device_.getExtendedDynamicState3Features();
+    switch (state) {
+        case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE: {
+            return isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME) &&
+                   physical_device_.getExtendedDynamicState2Features().extendedDynamicState2;
+        }
+        case VK_DYNAMIC_STATE_POLYGON_MODE_EXT: {
+            return isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME) &&
+                   dynamic_state3_features.extendedDynamicState3PolygonMode;
+        }
+        case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT: {
+            return isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME) &&
+                   dynamic_state3_features.extendedDynamicState3ColorBlendEnable;
+        }
+        case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT: {
+            return isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME) &&
+                   dynamic_state3_features.extendedDynamicState3ColorBlendEquation;
+        }
+        default: return true;
+    }
+}
+
+bool Device::isVertexAttributeDivisorSupported(std::uint32_t divisor) const {
+    if (divisor == 1) { return true; }
+    if (!isExtensionEnabled(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME)) { return false; }
+    const auto& features = physical_device_.getVertexAttributeDivisorFeatures();
+    if (divisor == 0) { return features.vertexAttributeInstanceRateZeroDivisor; }
+    return features.vertexAttributeInstanceRateDivisor &&
+           divisor <= physical_device_.getVertexAttributeDivisorProperties().maxVertexAttribDivisor;
+}
+
+bool Device::hasExtensionFunctions(std::string_view extension) const {
+    if (isExtensionEnabled(extension)) { return true; }
+    // Shader object extension provides commands of extended dynamic state 2 and 3 on its own
+    return use_shader_object_ && (extension == VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME ||
+                                  extension == VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+}
+
 bool Device::createSemaphore(VkSemaphore& semaphore) {
     VkResult result = vkCreateSemaphore(
         constAddressOf(VkSemaphoreCreateInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO}), nullptr, &semaphore);
@@ -444,6 +667,287 @@ bool Device::updateImage(const std::uint8_t* data, VkImage dst, Format format, s
     return true;
 }
 
+void Device::updateDescriptorSets(std::span<const VkWriteDescriptorSet> write_descriptors,
+                                  std::span<const VkCopyDescriptorSet> copy_descriptors) {
+    auto& batch = desc_write_batch_;
+    if (batch.nesting_level == 0 || !copy_descriptors.empty()) {
+        flushDescriptorWrites();
+        vkUpdateDescriptorSets(std::uint32_t(write_descriptors.size()), write_descriptors.data(),
+                               std::uint32_t(copy_descriptors.size()), copy_descriptors.data());
+        return;
+    }
+
+    // Info pointers are fixed up on flush, because info arrays can be reallocated
+    for (const auto& write : write_descriptors) {
+        batch.writes.push_back(write);
+        if (write.pImageInfo) {
+            batch.image_infos.insert(batch.image_infos.end(), write.pImageInfo,
+                                     write.pImageInfo + write.descriptorCount);
+        } else if (write.pBufferInfo) {
+            batch.buffer_infos.insert(batch.buffer_infos.end(), write.pBufferInfo,
+                                      write.pBufferInfo + write.descriptorCount);
+        }
+    }
+}
+
+void Device::updateDescriptorSetWithTemplate(VkDescriptorSet descriptor_set,
+                                             VkDescriptorUpdateTemplate update_template, const void* data) {
+    flushDescriptorWrites();  // preserve order of updates
+    vkUpdateDescriptorSetWithTemplate(descriptor_set, update_template, data);
+}
+
+VkDescriptorSetLayout Device::obtainSetLayout(const VkDescriptorSetLayoutCreateInfo& create_info) {
+    assert(!create_info.pNext);  // extension structures aren't a part of the key
+
+    // Bindings are ordered by numbers, so the order they are described in doesn't matter
+    uxs::inline_dynarray<const VkDescriptorSetLayoutBinding*, 16> bindings;
+    for (std::uint32_t n = 0; n < create_info.bindingCount; ++n) { bindings.push_back(&create_info.pBindings[n]); }
+    std::ranges::sort(bindings, {}, [](const auto* binding) { return binding->binding; });
+
+    ObjectKey key;
+    key.words.push_back(create_info.flags);
+    for (const auto* binding : bindings) {
+        key.words.push_back(binding->binding);
+        key.words.push_back(binding->descriptorType);
+        key.words.push_back(binding->descriptorCount);
+        key.words.push_back(binding->stageFlags);
+        key.words.push_back(binding->pImmutableSamplers ? 1 : 0);
+        if (!binding->pImmutableSamplers) { continue; }
+        for (std::uint32_t n = 0; n < binding->descriptorCount; ++n) {
+            key.words.push_back(std::uint64_t(binding->pImmutableSamplers[n]));
+        }
+    }
+
+    std::lock_guard lk(layouts_mtx_);
+
+    if (auto it = set_layouts_.find(key); it != set_layouts_.end()) {
+        ++it->second.ref_count;
+        return it->second.handle;
+    }
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VkResult result = vkCreateDescriptorSetLayout(&create_info, nullptr, &set_layout);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create layout for descriptor sets: {}", result);
+        return VK_NULL_HANDLE;
+    }
+
+    set_layouts_.emplace(std::move(key), InternedHandle<VkDescriptorSetLayout>{.handle = set_layout, .ref_count = 1});
+    return set_layout;
+}
+
+void Device::releaseSetLayout(VkDescriptorSetLayout set_layout) {
+    std::lock_guard lk(layouts_mtx_);
+    // Layouts are released rarely, so linear search is acceptable
+    auto it = std::ranges::find_if(set_layouts_,
+                                   [set_layout](const auto& item) { return item.second.handle == set_layout; });
+    if (it == set_layouts_.end() || --it->second.ref_count != 0) { return; }
+    vkDestroyDescriptorSetLayout(set_layout, nullptr);
+    set_layouts_.erase(it);
+}
+
+VkPipelineLayout Device::obtainPipelineLayout(const VkPipelineLayoutCreateInfo& create_info) {
+    assert(!create_info.pNext);
+
+    // Set layouts are interned, so their handles identify them
+    ObjectKey key;
+    key.words.push_back(create_info.flags);
+    key.words.push_back(create_info.setLayoutCount);
+    for (std::uint32_t n = 0; n < create_info.setLayoutCount; ++n) {
+        key.words.push_back(std::uint64_t(create_info.pSetLayouts[n]));
+    }
+    for (std::uint32_t n = 0; n < create_info.pushConstantRangeCount; ++n) {
+        const auto& range = create_info.pPushConstantRanges[n];
+        key.words.push_back(range.stageFlags);
+        key.words.push_back((std::uint64_t(range.offset) << 32) | range.size);
+    }
+
+    std::lock_guard lk(layouts_mtx_);
+
+    if (auto it = pipeline_layouts_.find(key); it != pipeline_layouts_.end()) {
+        ++it->second.ref_count;
+        return it->second.handle;
+    }
+
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    VkResult result = vkCreatePipelineLayout(&create_info, nullptr, &pipeline_layout);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create pipeline layout: {}", result);
+        return VK_NULL_HANDLE;
+    }
+
+    pipeline_layouts_.emplace(std::move(key),
+                              InternedHandle<VkPipelineLayout>{.handle = pipeline_layout, .ref_count = 1});
+    return pipeline_layout;
+}
+
+void Device::releasePipelineLayout(VkPipelineLayout pipeline_layout) {
+    std::lock_guard lk(layouts_mtx_);
+    auto it = std::ranges::find_if(pipeline_layouts_, [pipeline_layout](const auto& item) {
+        return item.second.handle == pipeline_layout;
+    });
+    if (it == pipeline_layouts_.end() || --it->second.ref_count != 0) { return; }
+    vkDestroyPipelineLayout(pipeline_layout, nullptr);
+    pipeline_layouts_.erase(it);
+}
+
+void Device::removeSampler(Sampler& sampler, const SamplerDesc& desc) {
+    std::lock_guard lk(layouts_mtx_);
+    auto it = samplers_.find(makeSamplerKey(desc));
+    if (it != samplers_.end() && it->second == &sampler) { samplers_.erase(it); }
+}
+
+std::uint64_t Device::obtainShaderModuleId(std::span<const std::uint8_t> bytecode) {
+    std::lock_guard lk(layouts_mtx_);
+
+    if (auto it = shader_module_ids_.find(
+            std::string_view{reinterpret_cast<const char*>(bytecode.data()), bytecode.size()});
+        it != shader_module_ids_.end()) {
+        ++it->second.ref_count;
+        return it->second.id;
+    }
+
+    const std::uint64_t id = next_shader_module_id_++;
+    InternedBytecode interned{.bytecode = DataBlob(bytecode.size()), .id = id, .ref_count = 1};
+    std::memcpy(interned.bytecode.getData(), bytecode.data(), bytecode.size());
+    const std::string_view key = interned.bytecode.getTextView();
+    shader_module_ids_.emplace(key, std::move(interned));
+    return id;
+}
+
+void Device::releaseShaderModuleId(std::uint64_t id) {
+    std::lock_guard lk(layouts_mtx_);
+    // Modules are released rarely, so linear search is acceptable
+    auto it = std::ranges::find_if(shader_module_ids_, [id](const auto& item) { return item.second.id == id; });
+    if (it == shader_module_ids_.end() || --it->second.ref_count != 0) { return; }
+    shader_module_ids_.erase(it);
+}
+
+VkPipeline Device::obtainPipelineLibrary(ObjectKey key, const VkGraphicsPipelineCreateInfo& create_info) {
+    {
+        std::lock_guard lk(pipelines_mtx_);
+        if (auto it = pipeline_libraries_.find(key); it != pipeline_libraries_.end()) {
+            ++it->second.ref_count;
+            return it->second.handle;
+        }
+    }
+
+    // Libraries are compiled without holding the lock: if the same library is compiled concurrently, the first one
+    // is taken
+    VkPipeline library{VK_NULL_HANDLE};
+    VkResult result = vkCreateGraphicsPipelines(VK_NULL_HANDLE, 1, &create_info, nullptr, &library);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create pipeline library: {}", result);
+        return VK_NULL_HANDLE;
+    }
+
+    std::lock_guard lk(pipelines_mtx_);
+    auto [it, is_inserted] = pipeline_libraries_.try_emplace(
+        std::move(key), InternedHandle<VkPipeline>{.handle = library, .ref_count = 0});
+    if (!is_inserted) { vkDestroyPipeline(library, nullptr); }
+    ++it->second.ref_count;
+    return it->second.handle;
+}
+
+void Device::releasePipelineLibrary(VkPipeline library) {
+    std::lock_guard lk(pipelines_mtx_);
+    auto it = std::ranges::find_if(pipeline_libraries_,
+                                   [library](const auto& item) { return item.second.handle == library; });
+    if (it == pipeline_libraries_.end() || --it->second.ref_count != 0) { return; }
+    vkDestroyPipeline(library, nullptr);
+    pipeline_libraries_.erase(it);
+}
+
+VkShaderEXT Device::obtainShader(ObjectKey key, const VkShaderCreateInfoEXT& create_info) {
+    {
+        std::lock_guard lk(pipelines_mtx_);
+        if (auto it = shaders_.find(key); it != shaders_.end()) {
+            ++it->second.ref_count;
+            return it->second.handle;
+        }
+    }
+
+    VkShaderEXT shader{VK_NULL_HANDLE};
+    VkResult result = vkCreateShadersEXT(1, &create_info, nullptr, &shader);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't create shader object: {}", result);
+        return VK_NULL_HANDLE;
+    }
+
+    std::lock_guard lk(pipelines_mtx_);
+    auto [it, is_inserted] = shaders_.try_emplace(std::move(key),
+                                                  InternedHandle<VkShaderEXT>{.handle = shader, .ref_count = 0});
+    if (!is_inserted) { vkDestroyShaderEXT(shader, nullptr); }
+    ++it->second.ref_count;
+    return it->second.handle;
+}
+
+void Device::releaseShader(VkShaderEXT shader) {
+    std::lock_guard lk(pipelines_mtx_);
+    auto it = std::ranges::find_if(shaders_, [shader](const auto& item) { return item.second.handle == shader; });
+    if (it == shaders_.end() || --it->second.ref_count != 0) { return; }
+    vkDestroyShaderEXT(shader, nullptr);
+    shaders_.erase(it);
+}
+
+void Device::removePipeline(Pipeline& pipeline) {
+    std::lock_guard lk(pipelines_mtx_);
+    auto it = std::ranges::find_if(pipelines_, [&pipeline](const auto& item) { return item.second == &pipeline; });
+    if (it != pipelines_.end()) { pipelines_.erase(it); }
+}
+
+VkDeviceAddress Device::getBufferDeviceAddress(VkBuffer buffer) {
+    return vkGetBufferDeviceAddress(constAddressOf(VkBufferDeviceAddressInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buffer,
+    }));
+}
+
+std::size_t Device::getDescriptorSize(VkDescriptorType type) const {
+    const auto& props = physical_device_.getDescriptorBufferProperties();
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER: return props.samplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: return props.combinedImageSamplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return props.sampledImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: return props.storageImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER: return props.uniformTexelBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: return props.storageTexelBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return props.uniformBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: return props.storageBufferDescriptorSize;
+        default: return 0;
+    }
+}
+
+void Device::getImageDescriptor(VkDescriptorType type, const VkDescriptorImageInfo& image_info, void* descriptor) {
+    VkDescriptorGetInfoEXT get_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = type};
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER: get_info.data.pSampler = &image_info.sampler; break;
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: get_info.data.pCombinedImageSampler = &image_info; break;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: get_info.data.pSampledImage = &image_info; break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: get_info.data.pStorageImage = &image_info; break;
+        default: assert(false); return;
+    }
+    vkGetDescriptorEXT(&get_info, getDescriptorSize(type), descriptor);
+}
+
+void Device::getBufferDescriptor(VkDescriptorType type, const VkDescriptorBufferInfo& buffer_info, void* descriptor) {
+    assert(buffer_info.range != VK_WHOLE_SIZE);  // must be resolved with `Buffer::getRange`
+    const VkDescriptorAddressInfoEXT address_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+        .address = getBufferDeviceAddress(buffer_info.buffer) + buffer_info.offset,
+        .range = buffer_info.range,
+        .format = VK_FORMAT_UNDEFINED,
+    };
+
+    VkDescriptorGetInfoEXT get_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT, .type = type};
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: get_info.data.pUniformBuffer = &address_info; break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: get_info.data.pStorageBuffer = &address_info; break;
+        default: assert(false); return;
+    }
+    vkGetDescriptorEXT(&get_info, getDescriptorSize(type), descriptor);
+}
+
 //@{ IDevice
 
 bool Device::waitDevice() {
@@ -462,24 +966,50 @@ util::ref_ptr<ISwapChain> Device::createSwapChain(ISurface& surface, const uxs::
 }
 
 util::ref_ptr<IShaderModule> Device::createShaderModule(DataBlob bytecode) {
+    auto shader_module = util::make_new<ShaderModule>(*this);
+    if (!shader_module->create(std::move(bytecode))) { return nullptr; }
+    return std::move(shader_module);
+}
+
+util::ref_ptr<IShaderModule> Device::createShaderModule(std::span<const std::uint8_t> bytecode) {
     auto shader_module = util::make_new<ShaderModule>(*this);
     if (!shader_module->create(bytecode)) { return nullptr; }
     return std::move(shader_module);
 }
 
-util::ref_ptr<IPipelineLayout> Device::createPipelineLayout(const uxs::db::value& config) {
+util::ref_ptr<IPipelineLayout> Device::createPipelineLayout(const uxs::db::value& config,
+                                                            std::span<ISampler* const> immutable_samplers) {
+    auto pipeline_layout = util::make_new<PipelineLayout>(*this);
+    if (!pipeline_layout->create(config, immutable_samplers)) { return nullptr; }
+    return std::move(pipeline_layout);
+}
+
+util::ref_ptr<IPipelineLayout> Device::createPipelineLayout(std::span<IShaderModule* const> shader_modules,
+                                                            const uxs::db::value& config,
+                                                            std::span<ISampler* const> immutable_samplers) {
     auto pipeline_layout = util::make_new<PipelineLayout>(*this);
-    if (!pipeline_layout->create(config)) { return nullptr; }
+    if (!pipeline_layout->create(shader_modules, config, immutable_samplers)) { return nullptr; }
     return std::move(pipeline_layout);
 }
 
 util::ref_ptr<IPipeline> Device::createPipeline(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
                                                 std::span<IShaderModule* const> shader_modules,
                                                 const uxs::db::value& config) {
-    auto pipeline = util::make_new<Pipeline>(*this, static_cast<RenderTarget&>(render_target),
-                                             static_cast<PipelineLayout&>(pipeline_layout));
-    if (!pipeline->create(shader_modules, config)) { return nullptr; }
-    return std::move(pipeline);
+    auto pipeline = obtainPipeline(render_target, pipeline_layout, shader_modules, config, false);
+    if (!pipeline) { return nullptr; }
+
+    // Cached pipeline could be still compiled asynchronously
+    if (pipeline->getStatus() == PipelineStatus::PENDING) {
+        pipeline_compiler_.wait(static_cast<Pipeline&>(*pipeline));
+    }
+    if (pipeline->getStatus() != PipelineStatus::READY) { return nullptr; }
+    return pipeline;
+}
+
+util::ref_ptr<IPipeline> Device::createPipelineAsync(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
+                                                     std::span<IShaderModule* const> shader_modules,
+                                                     const uxs::db::value& config) {
+    return obtainPipeline(render_target, pipeline_layout, shader_modules, config, true);
 }
 
 util::ref_ptr<IBuffer> Device::createBuffer(BufferType type, std::uint64_t size) {
@@ -495,11 +1025,41 @@ util::ref_ptr<ITexture> Device::createTexture(const TextureDesc& desc) {
 }
 
 util::ref_ptr<ISampler> Device::createSampler(const SamplerDesc& desc) {
+    auto key = makeSamplerKey(desc);
+
+    std::unique_lock lk(layouts_mtx_);
+
+    // The sampler being destroyed can't be referenced again: its destructor waits for the lock to remove it
+    if (auto it = samplers_.find(key); it != samplers_.end() && it->second->try_ref()) {
+        util::ref_ptr<ISampler> sampler = it->second;
+        it->second->unref();
+        return sampler;
+    }
+
+    lk.unlock();
+
     auto sampler = util::make_new<Sampler>(*this);
     if (!sampler->create(desc)) { return nullptr; }
+
+    lk.lock();
+    samplers_.insert_or_assign(std::move(key), sampler.get());
     return std::move(sampler);
 }
 
+bool Device::isDynamicStateSupported(DynamicStateType type) const {
+    if (type == DynamicStateType::BLEND_STATE && !isDynamicStateSupported(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT)) {
+        return false;
+    }
+    return isDynamicStateSupported(TBL_VK_DYNAMIC_STATE[unsigned(type)]);
+}
+
+void Device::beginDescriptorUpdates() { ++desc_write_batch_.nesting_level; }
+
+void Device::endDescriptorUpdates() {
+    assert(desc_write_batch_.nesting_level > 0);
+    if (--desc_write_batch_.nesting_level == 0) { flushDescriptorWrites(); }
+}
+
 //@}
 
 bool Device::createStagingBuffer(VkDeviceSize size, StagingBuffer& buffer) {
@@ -530,3 +1090,101 @@ bool Device::createStagingBuffer(VkDeviceSize size, StagingBuffer& buffer) {
     buffer.size = size;
     return true;
 }
+
+Device::ObjectKey Device::makeSamplerKey(const SamplerDesc& desc) {
+    // Anisotropy is ignored by samplers without anisotropic filtering
+    const std::array words{
+        std::uint64_t(desc.filter),
+        std::uint64_t(desc.address_mode_u),
+        std::uint64_t(desc.address_mode_v),
+        std::uint64_t(desc.address_mode_w),
+        std::uint64_t(std::bit_cast<std::uint32_t>(desc.min_lod)),
+        std::uint64_t(std::bit_cast<std::uint32_t>(desc.max_lod)),
+        std::uint64_t(std::bit_cast<std::uint32_t>(desc.mip_lod_bias)),
+        std::uint64_t(desc.filter >= SamplerFilter::ANISOTROPIC ? desc.max_anisotropy : 0),
+    };
+
+    ObjectKey key;
+    key.words.assign(words.begin(), words.end());
+    return key;
+}
+
+util::ref_ptr<IPipeline> Device::obtainPipeline(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
+                                                std::span<IShaderModule* const> shader_modules,
+                                                const uxs::db::value& config, bool is_async) {
+    auto& vk_render_target = static_cast<RenderTarget&>(render_target);
+    auto& vk_pipeline_layout = static_cast<PipelineLayout&>(pipeline_layout);
+
+    const auto state = Pipeline::readState(shader_modules, config);
+    auto key = Pipeline::makeStateKey(state, vk_render_target, vk_pipeline_layout);
+
+    std::unique_lock lk(pipelines_mtx_);
+
+    util::ref_ptr<IPipeline> failed_pipeline;  // must be released without the lock: its destructor takes it
+
+    if (auto it = pipelines_.find(key); it != pipelines_.end() && it->second->try_ref()) {
+        util::ref_ptr<IPipeline> pipeline = it->second;
+        it->second->unref();
+        if (pipeline->getStatus() != PipelineStatus::FAILED) { return pipeline; }
+
+        // Failed pipeline is evicted, so the compilation is tried again
+        pipelines_.erase(it);
+        failed_pipeline = std::move(pipeline);
+    }
+
+    lk.unlock();
+    failed_pipeline.reset();
+
+    auto pipeline = util::make_new<Pipeline>(*this, vk_render_target, vk_pipeline_layout);
+    if (is_async) {
+        pipeline->createAsync(state);
+    } else if (!pipeline->create(state)) {
+        return nullptr;
+    }
+
+    // The entry of a pipeline being destroyed is taken over by the new one
+    lk.lock();
+    pipelines_.insert_or_assign(std::move(key), pipeline.get());
+    return std::move(pipeline);
+}
+
+std::size_t Device::ObjectKeyHash::operator()(const ObjectKey& key) const {
+    std::size_t hash = 0;
+    for (const std::uint64_t word : key.words) {
+        hash ^= std::hash<std::uint64_t>{}(word) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+void Device::flushDescriptorWrites() {
+    auto& batch = desc_write_batch_;
+    if (batch.writes.empty()) { return; }
+
+    std::size_t image_info_offset = 0;
+    std::size_t buffer_info_offset = 0;
+    for (auto& write : batch.writes) {
+        if (write.pImageInfo) {
+            write.pImageInfo = &batch.image_infos[image_info_offset];
+            image_info_offset += write.descriptorCount;
+        } else if (write.pBufferInfo) {
+            write.pBufferInfo = &batch.buffer_infos[buffer_info_offset];
+            buffer_info_offset += write.descriptorCount;
+        }
+    }
+
+    vkUpdateDescriptorSets(std::uint32_t(batch.writes.size()), batch.writes.data(), 0, nullptr);
+
+    batch.writes.clear();
+    batch.image_infos.clear();
+    batch.buffer_infos.clear();
+}
+
+void Device::beginFrame(std::uint32_t fif_count, std::uint64_t& n_last_frame) {
+    max_fif_count_ = std::max(fif_count, max_fif_count_);
+    if (!is_frame_begun_ || n_last_frame == n_frame_) {
+        ++n_frame_;
+        is_frame_begun_ = true;
+        if (bindless_heap_.isCreated()) { bindless_heap_.freeRetiredIndices(); }
+    }
+    n_last_frame = n_frame_;
+}
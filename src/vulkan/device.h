@@ -1,18 +1,40 @@
 #pragma once
 
+#include "bindless_descriptor_heap.h"
 #include "buffer.h"
 #include "command_buffer.h"
 #include "dev_queue.h"
+#include "pipeline_compiler.h"
 
 #include <uxs/dynarray.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 namespace app3d::rel::vulkan {
 
 class RenderingDriver;
 class PhysicalDevice;
+class Pipeline;
+class Sampler;
 
 class Device final : public util::ref_counter, public IDevice {
  public:
+    // Normalized description of an interned object
+    struct ObjectKey {
+        uxs::inline_dynarray<std::uint64_t, 32> words;
+        bool operator==(const ObjectKey& other) const { return std::ranges::equal(words, other.words); }
+    };
+
+    struct ObjectKeyHash {
+        std::size_t operator()(const ObjectKey& key) const;
+    };
+
     Device(RenderingDriver& instance, PhysicalDevice& physical_device);
     ~Device() override;
 
@@ -33,6 +55,10 @@ class Device final : public util::ref_counter, public IDevice {
     const DeviceVkFuncTable& getVkFuncs() { return vk_funcs_; }
 
     bool create(const uxs::db::value& caps);
+    bool isExtensionEnabled(std::string_view extension) const;
+    // Optional state of extended dynamic state 2 and 3 can be made dynamic only if its feature is enabled
+    bool isDynamicStateSupported(VkDynamicState state) const;
+    bool isVertexAttributeDivisorSupported(std::uint32_t divisor) const;
     bool createSemaphore(VkSemaphore& semaphore);
     bool createFence(bool signaled, VkFence& fence);
     bool waitForFences(std::span<const VkFence> fences, VkBool32 wait_for_all, std::uint64_t timeout);
@@ -50,28 +76,81 @@ class Device final : public util::ref_counter, public IDevice {
                      std::span<const VkSemaphore> signal_semaphores);
 
     void updateDescriptorSets(std::span<const VkWriteDescriptorSet> write_descriptors,
-                              std::span<const VkCopyDescriptorSet> copy_descriptors) {
-        vkUpdateDescriptorSets(std::uint32_t(write_descriptors.size()), write_descriptors.data(),
-                               std::uint32_t(copy_descriptors.size()), copy_descriptors.data());
-    }
+                              std::span<const VkCopyDescriptorSet> copy_descriptors);
+    void updateDescriptorSetWithTemplate(VkDescriptorSet descriptor_set, VkDescriptorUpdateTemplate update_template,
+                                         const void* data);
+    // Writes batched by `beginDescriptorUpdates` must be flushed before their sets are freed or reset
+    void flushDescriptorWrites();
+
+    // Device frame is begun by the first render target begun after the previous frame is presented, or by a render
+    // target begun again within the same frame, if nothing is presented
+    void beginFrame(std::uint32_t fif_count, std::uint64_t& n_last_frame);
+    void endFrame() { is_frame_begun_ = false; }
+    std::uint64_t getFrameIndex() const { return n_frame_; }
+    // The render target, which begins a frame, waits for its frame `fif_count` frames ago, and submissions of all
+    // previous frames are finished before it
+    bool isFrameFinished(std::uint64_t n_frame) const { return n_frame_ - n_frame > max_fif_count_; }
+
+    // Identical set layouts and pipeline layouts are shared: handles are reference counted
+    VkDescriptorSetLayout obtainSetLayout(const VkDescriptorSetLayoutCreateInfo& create_info);
+    void releaseSetLayout(VkDescriptorSetLayout set_layout);
+    VkPipelineLayout obtainPipelineLayout(const VkPipelineLayoutCreateInfo& create_info);
+    void releasePipelineLayout(VkPipelineLayout pipeline_layout);
+    void removeSampler(Sampler& sampler, const SamplerDesc& desc);
+    // Shader modules with identical bytecode get the same ID, bytecode is compared entirely, not by its hash
+    std::uint64_t obtainShaderModuleId(std::span<const std::uint8_t> bytecode);
+    void releaseShaderModuleId(std::uint64_t id);
+    void removePipeline(Pipeline& pipeline);
+    // Pipeline library parts are shared by pipelines, can be called from any thread
+    VkPipeline obtainPipelineLibrary(ObjectKey key, const VkGraphicsPipelineCreateInfo& create_info);
+    void releasePipelineLibrary(VkPipeline library);
+    // Shader objects are shared by pipelines with the same stages and layout, can be called from any thread
+    VkShaderEXT obtainShader(ObjectKey key, const VkShaderCreateInfoEXT& create_info);
+    void releaseShader(VkShaderEXT shader);
+
+    VkDeviceAddress getBufferDeviceAddress(VkBuffer buffer);
+    std::size_t getDescriptorSize(VkDescriptorType type) const;
+    void getImageDescriptor(VkDescriptorType type, const VkDescriptorImageInfo& image_info, void* descriptor);
+    void getBufferDescriptor(VkDescriptorType type, const VkDescriptorBufferInfo& buffer_info, void* descriptor);
+    // Stamps descriptor data of a set, so unchanged data isn't copied to descriptor buffers again, can be called from
+    // any thread
+    std::uint64_t makeDescriptorDataVersion() { return ++desc_data_version_; }
 
     PhysicalDevice& getPhysicalDevice() { return physical_device_; }
     VmaAllocator getAllocator() { return allocator_; }
     DevQueue& getGraphicsQueue() { return graphics_queue_; }
     DevQueue& getComputeQueue() { return compute_queue_; }
+    BindlessDescriptorHeap& getBindlessHeap() { return bindless_heap_; }
+    PipelineCompiler& getPipelineCompiler() { return pipeline_compiler_; }
+    bool useDescriptorBuffer() const { return use_descriptor_buffer_; }
+    VkDeviceSize getDescriptorBufferSize() const { return descriptor_buffer_size_; }
+    bool useGraphicsPipelineLibrary() const { return use_graphics_pipeline_library_; }
+    bool useShaderObject() const { return use_shader_object_; }
+    bool useMultiDraw() const { return use_multi_draw_; }
 
     //@{ IDevice
     util::ref_counter& getRefCounter() override { return *this; }
     bool waitDevice() override;
     util::ref_ptr<ISwapChain> createSwapChain(ISurface& surface, const uxs::db::value& opts) override;
     util::ref_ptr<IShaderModule> createShaderModule(DataBlob bytecode) override;
-    util::ref_ptr<IPipelineLayout> createPipelineLayout(const uxs::db::value& config) override;
+    util::ref_ptr<IShaderModule> createShaderModule(std::span<const std::uint8_t> bytecode) override;
+    util::ref_ptr<IPipelineLayout> createPipelineLayout(const uxs::db::value& config,
+                                                        std::span<ISampler* const> immutable_samplers) override;
+    util::ref_ptr<IPipelineLayout> createPipelineLayout(std::span<IShaderModule* const> shader_modules,
+                                                        const uxs::db::value& config,
+                                                        std::span<ISampler* const> immutable_samplers) override;
     util::ref_ptr<IPipeline> createPipeline(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
                                             std::span<IShaderModule* const> shader_modules,
                                             const uxs::db::value& config) override;
+    util::ref_ptr<IPipeline> createPipelineAsync(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
+                                                 std::span<IShaderModule* const> shader_modules,
+                                                 const uxs::db::value& config) override;
     util::ref_ptr<IBuffer> createBuffer(BufferType type, std::uint64_t size) override;
     util::ref_ptr<ITexture> createTexture(const TextureDesc& desc) override;
     util::ref_ptr<ISampler> createSampler(const SamplerDesc& desc) override;
+    bool isDynamicStateSupported(DynamicStateType type) const override;
+    void beginDescriptorUpdates() override;
+    void endDescriptorUpdates() override;
     //@}
 
  private:
@@ -79,10 +158,18 @@ class Device final : public util::ref_counter, public IDevice {
     PhysicalDevice& physical_device_;
     DeviceVkFuncTable vk_funcs_;
     VkDevice device_{VK_NULL_HANDLE};
+    std::vector<const char*> enabled_extensions_;
     VmaAllocator allocator_{VK_NULL_HANDLE};
     DevQueue graphics_queue_;
     DevQueue compute_queue_;
     DevQueue transfer_queue_;
+    BindlessDescriptorHeap bindless_heap_;
+    bool use_descriptor_buffer_ = false;
+    VkDeviceSize descriptor_buffer_size_ = 0;
+    bool use_graphics_pipeline_library_ = false;
+    bool use_shader_object_ = false;
+    bool use_multi_draw_ = false;
+    PipelineCompiler pipeline_compiler_;
 
     struct StagingBuffer {
         VkBuffer handle{VK_NULL_HANDLE};
@@ -96,12 +183,70 @@ class Device final : public util::ref_counter, public IDevice {
         CommandBuffer command_buffer;
     };
 
+    static constexpr std::array OPTIONAL_DEVICE_EXTENSIONS{
+        VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
+        VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME,
+    };
+
+    static constexpr std::uint32_t DEFAULT_BINDLESS_TEXTURE_COUNT = 4096;
+    static constexpr std::uint32_t DEFAULT_BINDLESS_SAMPLER_COUNT = 256;
+    static constexpr std::uint32_t DEFAULT_BINDLESS_BUFFER_COUNT = 4096;
+
+    static constexpr VkDeviceSize DEFAULT_DESCRIPTOR_BUFFER_SIZE = 1024 * 1024;
+
+    static constexpr std::uint32_t MAX_DEFAULT_PIPELINE_COMPILE_THREAD_COUNT = 4;
+
     static constexpr std::uint32_t TRANSFER_KIT_COUNT = 1;
     static constexpr std::uint64_t FINISH_TRANSFER_TIMEOUT = 500'000'000;
     std::uint32_t current_transfer_kit_ = 0;
     uxs::inline_dynarray<TransferKit, TRANSFER_KIT_COUNT> transfer_kits_;
 
+    struct DescriptorWriteBatch {
+        std::uint32_t nesting_level = 0;
+        std::vector<VkWriteDescriptorSet> writes;
+        std::vector<VkDescriptorImageInfo> image_infos;
+        std::vector<VkDescriptorBufferInfo> buffer_infos;
+    };
+
+    DescriptorWriteBatch desc_write_batch_;
+
+    std::uint64_t n_frame_ = 0;
+    std::uint32_t max_fif_count_ = 0;
+    bool is_frame_begun_ = false;
+
+    template<typename HandleTy>
+    struct InternedHandle {
+        HandleTy handle;
+        std::uint32_t ref_count;
+    };
+
+    // Samplers and pipelines aren't referenced by the caches: they remove themselves on destruction
+    std::unordered_map<ObjectKey, Sampler*, ObjectKeyHash> samplers_;
+    std::unordered_map<ObjectKey, Pipeline*, ObjectKeyHash> pipelines_;
+    std::unordered_map<ObjectKey, InternedHandle<VkPipeline>, ObjectKeyHash> pipeline_libraries_;
+    std::unordered_map<ObjectKey, InternedHandle<VkShaderEXT>, ObjectKeyHash> shaders_;
+    std::mutex pipelines_mtx_;  // pipelines, libraries and shaders can be created from background threads
+    std::unordered_map<ObjectKey, InternedHandle<VkDescriptorSetLayout>, ObjectKeyHash> set_layouts_;
+    std::unordered_map<ObjectKey, InternedHandle<VkPipelineLayout>, ObjectKeyHash> pipeline_layouts_;
+    std::mutex layouts_mtx_;  // samplers, layouts and shader modules can be created from background threads
+
+    // Keys are views of interned bytecode copies
+    struct InternedBytecode {
+        DataBlob bytecode;
+        std::uint64_t id;
+        std::uint32_t ref_count;
+    };
+
+    std::unordered_map<std::string_view, InternedBytecode> shader_module_ids_;
+    std::uint64_t next_shader_module_id_ = 1;
+    std::atomic<std::uint64_t> desc_data_version_{0};
+
+    bool hasExtensionFunctions(std::string_view extension) const;
     bool createStagingBuffer(VkDeviceSize size, StagingBuffer& buffer);
+    static ObjectKey makeSamplerKey(const SamplerDesc& desc);
+    util::ref_ptr<IPipeline> obtainPipeline(IRenderTarget& render_target, IPipelineLayout& pipeline_layout,
+                                            std::span<IShaderModule* const> shader_modules,
+                                            const uxs::db::value& config, bool is_async);
 };
 
 }  // namespace app3d::rel::vulkan
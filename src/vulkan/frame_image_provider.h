@@ -11,6 +11,7 @@ class CommandBuffer;
 
 class FrameImageProvider : public util::ref_counter {
  public:
+    virtual VkImage getImage(std::uint32_t image_index) = 0;
     virtual VkImageView getImageView(std::uint32_t image_index) = 0;
     virtual std::uint32_t getImageCount() const = 0;
     virtual std::uint32_t getFifCount() const = 0;
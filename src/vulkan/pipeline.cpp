@@ -1,18 +1,117 @@
 #include "pipeline.h"
 
+#include "command_buffer.h"
 #include "device.h"
 #include "pipeline_layout.h"
 #include "render_target.h"
+#include "rendering_driver.h"
 #include "shader_module.h"
 #include "tables.h"
 #include "vulkan_logger.h"
 
 #include "rel/tables.h"
 
+#include <algorithm>
+#include <bit>
+
 using namespace app3d;
 using namespace app3d::rel;
 using namespace app3d::rel::vulkan;
 
+namespace {
+constexpr std::array LIBRARY_PARTS{
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+};
+
+// All graphics stages must have bound shader objects, unused stages are bound to `VK_NULL_HANDLE`
+constexpr std::array GRAPHICS_SHADER_STAGES{
+    VK_SHADER_STAGE_VERTEX_BIT,
+    VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+    VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+    VK_SHADER_STAGE_GEOMETRY_BIT,
+    VK_SHADER_STAGE_FRAGMENT_BIT,
+};
+
+void readSpecialization(const uxs::db::value& specialization, Pipeline::State::Stage& stage) {
+    uxs::inline_dynarray<std::pair<std::uint32_t, std::uint32_t>> constants;
+    for (const auto& constant : specialization.as_array()) {
+        std::uint32_t word = 0;
+        switch (parseConstantType(constant.value_or<std::string_view>("type", "UINT"))) {
+            case ConstantType::BOOL: word = constant.value<bool>("value") ? VK_TRUE : VK_FALSE; break;
+            case ConstantType::INT: word = std::uint32_t(constant.value<std::int32_t>("value")); break;
+            case ConstantType::UINT: word = constant.value<std::uint32_t>("value"); break;
+            case ConstantType::FLOAT: word = std::bit_cast<std::uint32_t>(constant.value<float>("value")); break;
+            default: break;
+        }
+        constants.emplace_back(constant.value<std::uint32_t>("id"), word);
+    }
+
+    std::ranges::sort(constants, {}, &std::pair<std::uint32_t, std::uint32_t>::first);
+    if (std::ranges::adjacent_find(constants, {}, &std::pair<std::uint32_t, std::uint32_t>::first) !=
+        constants.end()) {
+        throw uxs::db::database_error("duplicate specialization constant ID");
+    }
+
+    for (const auto& [id, word] : constants) {
+        stage.specialization_entries.emplace_back(VkSpecializationMapEntry{
+            .constantID = id,
+            .offset = std::uint32_t(stage.specialization_data.size() * sizeof(std::uint32_t)),
+            .size = sizeof(std::uint32_t),
+        });
+        stage.specialization_data.push_back(word);
+    }
+}
+
+VkSpecializationInfo makeSpecializationInfo(const Pipeline::State::Stage& stage) {
+    return VkSpecializationInfo{
+        .mapEntryCount = std::uint32_t(stage.specialization_entries.size()),
+        .pMapEntries = stage.specialization_entries.data(),
+        .dataSize = stage.specialization_data.size() * sizeof(std::uint32_t),
+        .pData = stage.specialization_data.data(),
+    };
+}
+
+void appendStageWords(const Pipeline::State::Stage& stage, Device::ObjectKey& key) {
+    key.words.push_back(stage.module->getId());
+    key.words.push_back(std::uint64_t(stage.stage));
+    key.words.push_back(std::hash<std::string>{}(stage.entry));
+    key.words.push_back(stage.specialization_entries.size());
+    for (std::size_t n = 0; n < stage.specialization_entries.size(); ++n) {
+        key.words.push_back(std::uint64_t(stage.specialization_entries[n].constantID) |
+                            std::uint64_t(stage.specialization_data[n]) << 32);
+    }
+}
+
+void appendVertexInputWords(const Pipeline::State& state, Device::ObjectKey& key) {
+    key.words.push_back(state.vertex_bindings.size());
+    for (const auto& binding : state.vertex_bindings) {
+        key.words.push_back(std::uint64_t(binding.binding) | std::uint64_t(binding.inputRate) << 32);
+        key.words.push_back(binding.stride);
+    }
+
+    key.words.push_back(state.vertex_attributes.size());
+    for (const auto& attribute : state.vertex_attributes) {
+        key.words.push_back(std::uint64_t(attribute.location) | std::uint64_t(attribute.binding) << 32);
+        key.words.push_back(std::uint64_t(attribute.format) | std::uint64_t(attribute.offset) << 32);
+    }
+
+    key.words.push_back(state.vertex_binding_divisors.size());
+    for (const auto& divisor : state.vertex_binding_divisors) {
+        key.words.push_back(std::uint64_t(divisor.binding) | std::uint64_t(divisor.divisor) << 32);
+    }
+
+    key.words.push_back(std::uint64_t(state.topology));
+}
+
+void appendDynamicStateWords(const Pipeline::State& state, Device::ObjectKey& key) {
+    key.words.push_back(state.dynamic_states.size());
+    for (const VkDynamicState dynamic_state : state.dynamic_states) { key.words.push_back(dynamic_state); }
+}
+}  // namespace
+
 // --------------------------------------------------------
 // Pipeline class implementation
 
@@ -20,45 +119,77 @@ Pipeline::Pipeline(Device& device, RenderTarget& render_target, PipelineLayout&
     : device_(util::not_null{&device}), render_target_(util::not_null{&render_target}),
       pipeline_layout_(util::not_null{&pipeline_layout}) {}
 
-Pipeline::~Pipeline() { device_->vkDestroyPipeline(pipeline_, nullptr); }
+Pipeline::~Pipeline() {
+    if (is_async_) { device_->getPipelineCompiler().cancel(*this); }
+    device_->removePipeline(*this);
+    device_->vkDestroyPipeline(optimized_pipeline_.load(), nullptr);
+    device_->vkDestroyPipeline(pipeline_, nullptr);
+    for (VkPipeline library : libraries_) {
+        if (library != VK_NULL_HANDLE) { device_->releasePipelineLibrary(library); }
+    }
+    for (VkShaderEXT shader : shaders_) {
+        if (shader != VK_NULL_HANDLE) { device_->releaseShader(shader); }
+    }
+}
 
-bool Pipeline::create(std::span<IShaderModule* const> shader_modules, const uxs::db::value& config) {
-    // Shader stages :
+Pipeline::State Pipeline::readState(std::span<IShaderModule* const> shader_modules, const uxs::db::value& config) {
+    State state;
 
-    uxs::inline_dynarray<VkPipelineShaderStageCreateInfo> shader_stage_create_infos;
+    // Shader stages :
 
     const auto& shader_stages = config.value("stages");
-    shader_stage_create_infos.reserve(shader_stages.size());
+    state.stages.reserve(shader_modules.size());
 
     std::uint32_t def_module_index = 0;
     for (const auto& module : shader_stages.as_array()) {
         const std::uint32_t index = module.value_or<std::uint32_t>("module_index", def_module_index++);
         if (index >= shader_modules.size()) { throw uxs::db::database_error("shader module index out of range"); }
-        const auto shader_stage = parseShaderStage(module.value("stage").as_string_view());
-        shader_stage_create_infos.emplace_back(VkPipelineShaderStageCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        auto& shader_module = static_cast<ShaderModule&>(*shader_modules[index]);
+        const auto& stage = module.value("stage");
+        if (stage.is_null() && !shader_module.hasReflection()) {
+            throw uxs::db::database_error("stage must be specified for shader module without reflection");
+        }
+        const auto shader_stage = !stage.is_null() ? parseShaderStage(stage.as_string_view()) :
+                                                     shader_module.getReflection().stage;
+        State::Stage stage_state{
+            .module = &shader_module,
             .stage = TBL_VK_SHADER_STAGE[unsigned(shader_stage)],
-            .module = static_cast<ShaderModule&>(*shader_modules[index]).getHandle(),
-            .pName = module.value_or<const char*>("entry", "main"),
-        });
+            .entry = std::string(module.value_or<std::string_view>("entry", "main")),
+        };
+        readSpecialization(module.value("specialization"), stage_state);
+        state.stages.push_back(std::move(stage_state));
     }
 
-    // Vertex layouts :
+    // If stages aren't specified, each shader module is a stage with `main` entry point
+    if (shader_stages.is_null()) {
+        for (auto* module : shader_modules) {
+            auto& shader_module = static_cast<ShaderModule&>(*module);
+            if (!shader_module.hasReflection()) {
+                throw uxs::db::database_error("stages must be specified for shader modules without reflection");
+            }
+            state.stages.emplace_back(State::Stage{
+                .module = &shader_module,
+                .stage = TBL_VK_SHADER_STAGE[unsigned(shader_module.getReflection().stage)],
+                .entry = "main",
+            });
+        }
+    }
 
-    uxs::inline_dynarray<VkVertexInputBindingDescription> vertex_input_binding_descriptions;
-    uxs::inline_dynarray<VkVertexInputAttributeDescription> vertex_attribute_descriptions;
+    // Vertex layouts :
 
     const auto& vertex_layouts = config.value("vertex_layouts");
 
+    const auto align_up = [](auto v, auto alignment) { return (v + alignment - 1) & ~(alignment - 1); };
+
     std::uint32_t def_slot = 0;
 
     for (const auto& layout : vertex_layouts.as_array()) {
         const std::uint32_t slot = layout.value_or<std::uint32_t>("slot", def_slot);
         def_slot = slot + 1;
 
-        const auto& attributes = layout.value("attributes");
+        const auto input_rate = parseVertexInputRate(layout.value_or<std::string_view>("input_rate", "VERTEX"));
 
-        const auto align_up = [](auto v, auto alignment) { return (v + alignment - 1) & ~(alignment - 1); };
+        const auto& attributes = layout.value("attributes");
 
         std::uint32_t def_location = 0;
         std::uint32_t def_offset = 0;
@@ -76,33 +207,278 @@ bool Pipeline::create(std::span<IShaderModule* const> shader_modules, const uxs:
             const std::uint32_t offset = attribute.value_or<std::uint32_t>("offset", def_offset);
             def_offset = offset + TBL_FORMAT_SIZE[unsigned(format)];
 
-            vertex_attribute_descriptions.emplace_back(VkVertexInputAttributeDescription{
+            state.vertex_attributes.emplace_back(VkVertexInputAttributeDescription{
                 .location = location, .binding = slot, .format = TBL_VK_FORMAT[unsigned(format)], .offset = offset});
         }
 
         const std::uint32_t stride = layout.value_or<std::uint32_t>("stride", align_up(def_offset, max_alignment));
-        vertex_input_binding_descriptions.emplace_back(VkVertexInputBindingDescription{
+        state.vertex_bindings.emplace_back(VkVertexInputBindingDescription{
             .binding = slot,
             .stride = stride,
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+            .inputRate = TBL_VK_VERTEX_INPUT_RATE[unsigned(input_rate)],
         });
+
+        // Instance data advances once per `divisor` instances, zero divisor gives the same data to all instances
+        if (input_rate == VertexInputRate::INSTANCE) {
+            const std::uint32_t divisor = layout.value_or<std::uint32_t>("divisor", 1);
+            if (divisor != 1) {
+                state.vertex_binding_divisors.emplace_back(
+                    VkVertexInputBindingDivisorDescriptionEXT{.binding = slot, .divisor = divisor});
+            }
+        }
+    }
+
+    // If vertex layouts aren't specified, vertex shader inputs are tightly packed into slot 0 in location order
+    if (vertex_layouts.is_null()) {
+        std::uint32_t def_offset = 0;
+        std::uint32_t max_alignment = 1;
+
+        for (const auto& stage : state.stages) {
+            if (stage.stage != VK_SHADER_STAGE_VERTEX_BIT) { continue; }
+            if (!stage.module->hasReflection()) {
+                throw uxs::db::database_error("vertex layouts must be specified for vertex shader without reflection");
+            }
+
+            for (const auto& input : stage.module->getReflection().vertex_inputs) {
+                const std::uint32_t attribute_alignment = TBL_FORMAT_ALIGNMENT[unsigned(input.format)];
+                def_offset = align_up(def_offset, attribute_alignment);
+                max_alignment = std::max(attribute_alignment, max_alignment);
+
+                state.vertex_attributes.emplace_back(VkVertexInputAttributeDescription{
+                    .location = input.location,
+                    .binding = 0,
+                    .format = TBL_VK_FORMAT[unsigned(input.format)],
+                    .offset = def_offset,
+                });
+
+                def_offset += TBL_FORMAT_SIZE[unsigned(input.format)];
+            }
+        }
+
+        if (!state.vertex_attributes.empty()) {
+            state.vertex_bindings.emplace_back(VkVertexInputBindingDescription{
+                .binding = 0,
+                .stride = align_up(def_offset, max_alignment),
+                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+            });
+        }
     }
 
     // Others :
 
+    state.topology = TBL_VK_PRIMITIVE_TOPOLOGY[unsigned(
+        parsePrimitiveTopology(config.value_or<std::string_view>("primitive_topology", "TRIANGLES")))];
+
+    state.dynamic_states.push_back(VK_DYNAMIC_STATE_VIEWPORT);
+    state.dynamic_states.push_back(VK_DYNAMIC_STATE_SCISSOR);
+    if (config.value<bool>("dynamic_primitive_topology")) {
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY);
+    }
+    if (config.value<bool>("dynamic_vertex_stride")) {
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_VERTEX_INPUT_BINDING_STRIDE);
+    }
+
+    // Fixed-function state, which can be changed by render target after the pipeline is bound
+    if (config.value<bool>("dynamic_cull_mode")) { state.dynamic_states.push_back(VK_DYNAMIC_STATE_CULL_MODE); }
+    if (config.value<bool>("dynamic_front_face")) { state.dynamic_states.push_back(VK_DYNAMIC_STATE_FRONT_FACE); }
+    if (config.value<bool>("dynamic_depth_test")) {
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE);
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE);
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP);
+    }
+    if (config.value<bool>("dynamic_depth_bias")) {
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE);
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_BIAS);
+    }
+    if (config.value<bool>("dynamic_polygon_mode")) {
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+    }
+    if (config.value<bool>("dynamic_blend")) {
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+        state.dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    }
+
+    // Normalization : the order of stages, slots, attributes and dynamic states doesn't affect the pipeline
+
+    std::ranges::sort(state.stages, {}, &State::Stage::stage);
+    std::ranges::sort(state.vertex_bindings, {}, &VkVertexInputBindingDescription::binding);
+    std::ranges::sort(state.vertex_attributes, {}, &VkVertexInputAttributeDescription::location);
+    std::ranges::sort(state.vertex_binding_divisors, {}, &VkVertexInputBindingDivisorDescriptionEXT::binding);
+    std::ranges::sort(state.dynamic_states);
+    return state;
+}
+
+Device::ObjectKey Pipeline::makeStateKey(const State& state, RenderTarget& render_target,
+                                         const PipelineLayout& pipeline_layout) {
+    Device::ObjectKey key;
+
+    // Layout object, not only its handle, is a part of the key: pipeline exposes its layout with slot mapping
+    key.words.push_back(std::uint64_t(reinterpret_cast<std::uintptr_t>(&pipeline_layout)));
+
+    // Render pass compatibility
+    key.words.push_back(std::uint64_t(render_target.getRenderPass()));
+    key.words.push_back(render_target.useDepth() ? 1 : 0);
+
+    key.words.push_back(state.stages.size());
+    for (const auto& stage : state.stages) { appendStageWords(stage, key); }
+
+    appendVertexInputWords(state, key);
+    appendDynamicStateWords(state, key);
+    return key;
+}
+
+bool Pipeline::create(const State& state) {
+    if (!is_async_) { setDynamicStateMask(state); }  // already set by `createAsync`
+    if (!compile(state)) {
+        status_ = PipelineStatus::FAILED;
+        return false;
+    }
+
+    status_ = PipelineStatus::READY;
+
+    // Fast-linked pipeline is replaced with the optimized one, when it's linked in background
+    if (libraries_[0] != VK_NULL_HANDLE && !is_async_) {
+        is_async_ = true;
+        device_->getPipelineCompiler().enqueue(*this);
+    }
+    return true;
+}
+
+void Pipeline::createAsync(const State& state) {
+    setDynamicStateMask(state);
+    pending_state_ = state;
+    pending_modules_.reserve(state.stages.size());
+    for (const auto& stage : state.stages) { pending_modules_.emplace_back(util::not_null{stage.module}); }
+    is_async_ = true;
+    device_->getPipelineCompiler().enqueue(*this);
+}
+
+void Pipeline::compilePending() {
+    if (pending_state_) {
+        const bool is_created = create(*pending_state_);
+        pending_state_.reset();
+        pending_modules_.clear();
+        if (!is_created || libraries_[0] == VK_NULL_HANDLE) { return; }
+    }
+
+    VkPipeline optimized_pipeline{VK_NULL_HANDLE};
+    if (link(true, optimized_pipeline)) { optimized_pipeline_ = optimized_pipeline; }
+}
+
+void Pipeline::bind(CommandBuffer& command_buffer) {
+    if (!device_->useShaderObject()) {
+        command_buffer.vkCmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, getHandle());
+        return;
+    }
+
+    std::array<VkShaderEXT, GRAPHICS_SHADER_STAGES.size()> shaders{};
+    for (std::size_t n = 0; n < shader_stages_.size(); ++n) {
+        const auto it = std::ranges::find(GRAPHICS_SHADER_STAGES, shader_stages_[n]);
+        if (it != GRAPHICS_SHADER_STAGES.end()) { shaders[it - GRAPHICS_SHADER_STAGES.begin()] = shaders_[n]; }
+    }
+    command_buffer.vkCmdBindShadersEXT(std::uint32_t(GRAPHICS_SHADER_STAGES.size()), GRAPHICS_SHADER_STAGES.data(),
+                                       shaders.data());
+
+    // The same state, as baked into pipelines by `compile`, the render target applies its own dynamic state after this
+    command_buffer.vkCmdSetVertexInputEXT(std::uint32_t(vertex_bindings_.size()), vertex_bindings_.data(),
+                                          std::uint32_t(vertex_attributes_.size()), vertex_attributes_.data());
+    command_buffer.vkCmdSetPrimitiveTopologyEXT(topology_);
+    command_buffer.vkCmdSetPrimitiveRestartEnableEXT(VK_FALSE);
+
+    command_buffer.vkCmdSetRasterizerDiscardEnableEXT(VK_FALSE);
+    command_buffer.vkCmdSetPolygonModeEXT(VK_POLYGON_MODE_FILL);
+    command_buffer.vkCmdSetCullModeEXT(VK_CULL_MODE_BACK_BIT);
+    command_buffer.vkCmdSetFrontFaceEXT(VK_FRONT_FACE_COUNTER_CLOCKWISE);
+    command_buffer.vkCmdSetDepthBiasEnableEXT(VK_FALSE);
+    command_buffer.vkCmdSetLineWidth(1.0f);
+
+    const VkSampleMask sample_mask = ~VkSampleMask(0);
+    command_buffer.vkCmdSetRasterizationSamplesEXT(VK_SAMPLE_COUNT_1_BIT);
+    command_buffer.vkCmdSetSampleMaskEXT(VK_SAMPLE_COUNT_1_BIT, &sample_mask);
+    command_buffer.vkCmdSetAlphaToCoverageEnableEXT(VK_FALSE);
+
+    // This state must be set only if corresponding features are enabled
+    const auto& features = device_->getPhysicalDevice().getFeatures();
+    if (features.alphaToOne) { command_buffer.vkCmdSetAlphaToOneEnableEXT(VK_FALSE); }
+    if (features.logicOp) { command_buffer.vkCmdSetLogicOpEnableEXT(VK_FALSE); }
+    if (features.depthClamp) { command_buffer.vkCmdSetDepthClampEnableEXT(VK_FALSE); }
+
+    const bool use_depth = render_target_->useDepth();
+    command_buffer.vkCmdSetDepthTestEnableEXT(use_depth ? VK_TRUE : VK_FALSE);
+    command_buffer.vkCmdSetDepthWriteEnableEXT(use_depth ? VK_TRUE : VK_FALSE);
+    command_buffer.vkCmdSetDepthCompareOpEXT(VK_COMPARE_OP_LESS_OR_EQUAL);
+    command_buffer.vkCmdSetDepthBoundsTestEnableEXT(VK_FALSE);
+    command_buffer.vkCmdSetStencilTestEnableEXT(VK_FALSE);
+
+    const VkBool32 blend_enable = VK_FALSE;
+    const VkColorComponentFlags color_write_mask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                                   VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    command_buffer.vkCmdSetColorBlendEnableEXT(0, 1, &blend_enable);
+    command_buffer.vkCmdSetColorWriteMaskEXT(0, 1, &color_write_mask);
+}
+
+void Pipeline::setDynamicStateMask(const State& state) {
+    dynamic_state_mask_ = 0;
+    for (unsigned type = 0; type < unsigned(DynamicStateType::TOTAL_COUNT); ++type) {
+        const VkDynamicState vk_state = TBL_VK_DYNAMIC_STATE[type];
+        if (device_->useShaderObject() || std::ranges::binary_search(state.dynamic_states, vk_state)) {
+            dynamic_state_mask_ |= 1u << type;
+        }
+    }
+}
+
+bool Pipeline::compile(const State& state) {
+    for (const VkDynamicState dynamic_state : state.dynamic_states) {
+        if (!device_->isDynamicStateSupported(dynamic_state)) {
+            logError(LOG_VK "dynamic state {} is not supported", unsigned(dynamic_state));
+            return false;
+        }
+    }
+
+    for (const auto& divisor : state.vertex_binding_divisors) {
+        if (!device_->isVertexAttributeDivisorSupported(divisor.divisor)) {
+            logError(LOG_VK "vertex attribute divisor {} is not supported", divisor.divisor);
+            return false;
+        }
+    }
+
+    if (device_->useShaderObject()) { return createShaders(state); }
+
+    uxs::inline_dynarray<VkSpecializationInfo> specialization_infos;
+    uxs::inline_dynarray<VkPipelineShaderStageCreateInfo> shader_stage_create_infos;
+    specialization_infos.reserve(state.stages.size());
+    shader_stage_create_infos.reserve(state.stages.size());
+    for (const auto& stage : state.stages) {
+        specialization_infos.push_back(makeSpecializationInfo(stage));
+        shader_stage_create_infos.emplace_back(VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = stage.stage,
+            .module = stage.module->getHandle(),
+            .pName = stage.entry.c_str(),
+            .pSpecializationInfo = !stage.specialization_entries.empty() ? &specialization_infos.back() : nullptr,
+        });
+    }
+
+    // Others :
+
+    const VkPipelineVertexInputDivisorStateCreateInfoEXT vertex_input_divisor_state_create_info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_DIVISOR_STATE_CREATE_INFO_EXT,
+        .vertexBindingDivisorCount = std::uint32_t(state.vertex_binding_divisors.size()),
+        .pVertexBindingDivisors = state.vertex_binding_divisors.data(),
+    };
+
     const VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount = std::uint32_t(vertex_input_binding_descriptions.size()),
-        .pVertexBindingDescriptions = vertex_input_binding_descriptions.data(),
-        .vertexAttributeDescriptionCount = std::uint32_t(vertex_attribute_descriptions.size()),
-        .pVertexAttributeDescriptions = vertex_attribute_descriptions.data(),
+        .pNext = !state.vertex_binding_divisors.empty() ? &vertex_input_divisor_state_create_info : nullptr,
+        .vertexBindingDescriptionCount = std::uint32_t(state.vertex_bindings.size()),
+        .pVertexBindingDescriptions = state.vertex_bindings.data(),
+        .vertexAttributeDescriptionCount = std::uint32_t(state.vertex_attributes.size()),
+        .pVertexAttributeDescriptions = state.vertex_attributes.data(),
     };
 
-    const auto topology = parsePrimitiveTopology(config.value_or<std::string_view>("primitive_topology", "TRIANGLES"));
-
     const VkPipelineInputAssemblyStateCreateInfo input_assembly_state_create_info{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .topology = TBL_VK_PRIMITIVE_TOPOLOGY[unsigned(topology)],
+        .topology = state.topology,
         .primitiveRestartEnable = VK_FALSE,
     };
 
@@ -168,24 +544,15 @@ bool Pipeline::create(std::span<IShaderModule* const> shader_modules, const uxs:
         .blendConstants = {1.0f, 1.0f, 1.0f, 1.0f},
     };
 
-    uxs::inline_dynarray<VkDynamicState> dynamic_states;
-    dynamic_states.push_back(VK_DYNAMIC_STATE_VIEWPORT);
-    dynamic_states.push_back(VK_DYNAMIC_STATE_SCISSOR);
-    if (config.value<bool>("dynamic_primitive_topology")) {
-        dynamic_states.push_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY);
-    }
-    if (config.value<bool>("dynamic_vertex_stride")) {
-        dynamic_states.push_back(VK_DYNAMIC_STATE_VERTEX_INPUT_BINDING_STRIDE);
-    }
-
     const VkPipelineDynamicStateCreateInfo dynamic_state_create_info{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount = std::uint32_t(dynamic_states.size()),
-        .pDynamicStates = dynamic_states.data(),
+        .dynamicStateCount = std::uint32_t(state.dynamic_states.size()),
+        .pDynamicStates = state.dynamic_states.data(),
     };
 
     const VkGraphicsPipelineCreateInfo graphics_pipeline_create_info{
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .flags = device_->useDescriptorBuffer() ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u,
         .stageCount = std::uint32_t(shader_stage_create_infos.size()),
         .pStages = shader_stage_create_infos.data(),
         .pVertexInputState = &vertex_input_state_create_info,
@@ -201,6 +568,10 @@ bool Pipeline::create(std::span<IShaderModule* const> shader_modules, const uxs:
         .basePipelineIndex = -1,
     };
 
+    if (device_->useGraphicsPipelineLibrary()) {
+        return createLibraries(state, graphics_pipeline_create_info) && link(false, pipeline_);
+    }
+
     VkResult result = device_->vkCreateGraphicsPipelines(VK_NULL_HANDLE, 1, &graphics_pipeline_create_info, nullptr,
                                                          &pipeline_);
     if (result != VK_SUCCESS) {
@@ -211,6 +582,187 @@ bool Pipeline::create(std::span<IShaderModule* const> shader_modules, const uxs:
     return true;
 }
 
+Device::ObjectKey Pipeline::makeLibraryKey(const State& state, VkGraphicsPipelineLibraryFlagBitsEXT part) const {
+    Device::ObjectKey key;
+    key.words.push_back(std::uint64_t(part));
+
+    switch (part) {
+        case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT: {
+            appendVertexInputWords(state, key);
+        } break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT: {
+            key.words.push_back(std::uint64_t(pipeline_layout_->getHandle()));
+            key.words.push_back(std::uint64_t(render_target_->getRenderPass()));
+            key.words.push_back(render_target_->useDepth() ? 1 : 0);
+            const bool is_fragment_part = part == VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+            for (const auto& stage : state.stages) {
+                if ((stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT) == is_fragment_part) { appendStageWords(stage, key); }
+            }
+        } break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT: {
+            key.words.push_back(std::uint64_t(render_target_->getRenderPass()));
+        } break;
+        default: break;
+    }
+
+    // Each library is created with the dynamic states of the whole pipeline, libraries linked together must match
+    appendDynamicStateWords(state, key);
+    return key;
+}
+
+bool Pipeline::createLibraries(const State& state, const VkGraphicsPipelineCreateInfo& create_info) {
+    // Stages are sorted, so the fragment shader is the last one
+    const auto fragment_stage = std::ranges::find(state.stages, VK_SHADER_STAGE_FRAGMENT_BIT, &State::Stage::stage);
+    const std::uint32_t pre_rasterization_stage_count = std::uint32_t(fragment_stage - state.stages.begin());
+
+    for (std::size_t n = 0; n < LIBRARY_PARTS.size(); ++n) {
+        const VkGraphicsPipelineLibraryCreateInfoEXT library_create_info{
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+            .flags = VkGraphicsPipelineLibraryFlagsEXT(LIBRARY_PARTS[n]),
+        };
+
+        // Each library takes only the state of its part
+        VkGraphicsPipelineCreateInfo part_create_info{
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .pNext = &library_create_info,
+            .flags = create_info.flags | VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+                     VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT,
+            .pDynamicState = create_info.pDynamicState,
+            .basePipelineIndex = -1,
+        };
+
+        switch (LIBRARY_PARTS[n]) {
+            case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT: {
+                part_create_info.pVertexInputState = create_info.pVertexInputState;
+                part_create_info.pInputAssemblyState = create_info.pInputAssemblyState;
+            } break;
+            case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT: {
+                part_create_info.stageCount = pre_rasterization_stage_count;
+                part_create_info.pStages = create_info.pStages;
+                part_create_info.pViewportState = create_info.pViewportState;
+                part_create_info.pRasterizationState = create_info.pRasterizationState;
+                part_create_info.layout = create_info.layout;
+                part_create_info.renderPass = create_info.renderPass;
+            } break;
+            case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT: {
+                part_create_info.stageCount = create_info.stageCount - pre_rasterization_stage_count;
+                part_create_info.pStages = create_info.pStages + pre_rasterization_stage_count;
+                part_create_info.pMultisampleState = create_info.pMultisampleState;
+                part_create_info.pDepthStencilState = create_info.pDepthStencilState;
+                part_create_info.layout = create_info.layout;
+                part_create_info.renderPass = create_info.renderPass;
+            } break;
+            case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT: {
+                part_create_info.pMultisampleState = create_info.pMultisampleState;
+                part_create_info.pColorBlendState = create_info.pColorBlendState;
+                part_create_info.renderPass = create_info.renderPass;
+            } break;
+            default: break;
+        }
+
+        libraries_[n] = device_->obtainPipelineLibrary(makeLibraryKey(state, LIBRARY_PARTS[n]), part_create_info);
+        if (libraries_[n] == VK_NULL_HANDLE) { return false; }
+    }
+
+    return true;
+}
+
+bool Pipeline::link(bool optimize, VkPipeline& pipeline) {
+    const VkPipelineLibraryCreateInfoKHR library_create_info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+        .libraryCount = std::uint32_t(libraries_.size()),
+        .pLibraries = libraries_.data(),
+    };
+
+    const VkGraphicsPipelineCreateInfo create_info{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &library_create_info,
+        .flags = (device_->useDescriptorBuffer() ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u) |
+                 (optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0u),
+        .layout = pipeline_layout_->getHandle(),
+        .basePipelineIndex = -1,
+    };
+
+    VkResult result = device_->vkCreateGraphicsPipelines(VK_NULL_HANDLE, 1, &create_info, nullptr, &pipeline);
+    if (result != VK_SUCCESS) {
+        logError(LOG_VK "couldn't link graphics pipeline: {}", result);
+        return false;
+    }
+
+    return true;
+}
+
+bool Pipeline::createShaders(const State& state) {
+    const auto set_layouts = pipeline_layout_->getSetLayouts();
+    const auto push_constant_ranges = pipeline_layout_->getPushConstantRanges();
+
+    shader_stages_.reserve(state.stages.size());
+    shaders_.reserve(state.stages.size());
+
+    for (std::size_t n = 0; n < state.stages.size(); ++n) {
+        const auto& stage = state.stages[n];
+        const auto& bytecode = stage.module->getBytecode();
+
+        // Stages are sorted, so the next one is the stage, which follows this one
+        const VkShaderStageFlags next_stage = n + 1 < state.stages.size() ? state.stages[n + 1].stage : 0;
+
+        const VkSpecializationInfo specialization_info = makeSpecializationInfo(stage);
+        const VkShaderCreateInfoEXT create_info{
+            .sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+            .stage = stage.stage,
+            .nextStage = next_stage,
+            .codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+            .codeSize = bytecode.getSize(),
+            .pCode = bytecode.getData(),
+            .pName = stage.entry.c_str(),
+            .setLayoutCount = std::uint32_t(set_layouts.size()),
+            .pSetLayouts = set_layouts.data(),
+            .pushConstantRangeCount = std::uint32_t(push_constant_ranges.size()),
+            .pPushConstantRanges = push_constant_ranges.data(),
+            .pSpecializationInfo = !stage.specialization_entries.empty() ? &specialization_info : nullptr,
+        };
+
+        // Set layouts and push constant ranges are identified by the interned layout handle
+        Device::ObjectKey key;
+        appendStageWords(stage, key);
+        key.words.push_back(next_stage);
+        key.words.push_back(std::uint64_t(pipeline_layout_->getHandle()));
+
+        const VkShaderEXT shader = device_->obtainShader(std::move(key), create_info);
+        if (shader == VK_NULL_HANDLE) { return false; }
+        shader_stages_.push_back(stage.stage);
+        shaders_.push_back(shader);
+    }
+
+    vertex_bindings_.reserve(state.vertex_bindings.size());
+    for (const auto& binding : state.vertex_bindings) {
+        const auto divisor = std::ranges::find(state.vertex_binding_divisors, binding.binding,
+                                               &VkVertexInputBindingDivisorDescriptionEXT::binding);
+        vertex_bindings_.emplace_back(VkVertexInputBindingDescription2EXT{
+            .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT,
+            .binding = binding.binding,
+            .stride = binding.stride,
+            .inputRate = binding.inputRate,
+            .divisor = divisor != state.vertex_binding_divisors.end() ? divisor->divisor : 1,
+        });
+    }
+
+    vertex_attributes_.reserve(state.vertex_attributes.size());
+    for (const auto& attribute : state.vertex_attributes) {
+        vertex_attributes_.emplace_back(VkVertexInputAttributeDescription2EXT{
+            .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT,
+            .location = attribute.location,
+            .binding = attribute.binding,
+            .format = attribute.format,
+            .offset = attribute.offset,
+        });
+    }
+
+    topology_ = state.topology;
+    return true;
+}
+
 //@{ IPipeline
 
 //@}
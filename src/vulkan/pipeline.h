@@ -1,27 +1,68 @@
 #pragma once
 
-#include "vulkan_api.h"
+#include "device.h"
 
-#include "interfaces/i_rendering_driver.h"
+#include <array>
+#include <atomic>
+#include <optional>
+#include <string>
 
 namespace app3d::rel::vulkan {
 
-class Device;
+class CommandBuffer;
 class RenderTarget;
 class PipelineLayout;
+class ShaderModule;
 
 class Pipeline final : public util::ref_counter, public IPipeline {
  public:
+    // Normalized pipeline state: defaults are resolved and lists are sorted, so equal states produce equal keys
+    struct State {
+        struct Stage {
+            ShaderModule* module;
+            VkShaderStageFlagBits stage;
+            std::string entry;
+            // Constants are sorted by ID, each one takes a 32-bit word of data
+            uxs::inline_dynarray<VkSpecializationMapEntry> specialization_entries;
+            uxs::inline_dynarray<std::uint32_t> specialization_data;
+        };
+
+        uxs::inline_dynarray<Stage> stages;
+        uxs::inline_dynarray<VkVertexInputBindingDescription> vertex_bindings;
+        uxs::inline_dynarray<VkVertexInputAttributeDescription> vertex_attributes;
+        // Only instance rate slots with divisors other than 1 are listed
+        uxs::inline_dynarray<VkVertexInputBindingDivisorDescriptionEXT> vertex_binding_divisors;
+        VkPrimitiveTopology topology{};
+        uxs::inline_dynarray<VkDynamicState> dynamic_states;
+    };
+
     Pipeline(Device& device, RenderTarget& render_target, PipelineLayout& pipeline_layout);
     ~Pipeline() override;
 
-    bool create(std::span<IShaderModule* const> shader_modules, const uxs::db::value& config);
+    static State readState(std::span<IShaderModule* const> shader_modules, const uxs::db::value& config);
+    static Device::ObjectKey makeStateKey(const State& state, RenderTarget& render_target,
+                                          const PipelineLayout& pipeline_layout);
 
-    VkPipeline getHandle() { return pipeline_; }
+    bool create(const State& state);
+    // Keeps the state and its shader modules until the pipeline is compiled by `compilePending` on a worker thread
+    void createAsync(const State& state);
+    // Compiles pending state and makes link-time optimized pipeline from libraries
+    void compilePending();
+
+    VkPipeline getHandle() {
+        const VkPipeline optimized_pipeline = optimized_pipeline_;
+        return optimized_pipeline != VK_NULL_HANDLE ? optimized_pipeline : pipeline_;
+    }
     PipelineLayout& getLayout() { return *pipeline_layout_; }
+    // All the state is dynamic with shader objects
+    bool isDynamicState(DynamicStateType type) const { return (dynamic_state_mask_ & (1u << unsigned(type))) != 0; }
+    // Binds the pipeline, or its shader objects and the whole state, if shader objects are used: unlike pipelines,
+    // shader objects reset all fixed-function state on every bind, the render target applies its dynamic state after
+    void bind(CommandBuffer& command_buffer);
 
     //@{ IPipeline
     util::ref_counter& getRefCounter() override { return *this; }
+    PipelineStatus getStatus() const override { return status_; }
     //@}
 
  private:
@@ -29,6 +70,27 @@ class Pipeline final : public util::ref_counter, public IPipeline {
     util::ref_ptr<RenderTarget> render_target_;
     util::ref_ptr<PipelineLayout> pipeline_layout_;
     VkPipeline pipeline_{VK_NULL_HANDLE};
+    std::atomic<VkPipeline> optimized_pipeline_{VK_NULL_HANDLE};
+    // Vertex input, pre-rasterization, fragment shader and fragment output parts, if graphics pipeline library is used
+    std::array<VkPipeline, 4> libraries_{};
+    // Shader objects with the state to set on binding, if shader objects are used instead of pipelines
+    uxs::inline_dynarray<VkShaderStageFlagBits> shader_stages_;
+    uxs::inline_dynarray<VkShaderEXT> shaders_;
+    uxs::inline_dynarray<VkVertexInputBindingDescription2EXT> vertex_bindings_;
+    uxs::inline_dynarray<VkVertexInputAttributeDescription2EXT> vertex_attributes_;
+    VkPrimitiveTopology topology_{};
+    std::uint32_t dynamic_state_mask_ = 0;  // bit per `DynamicStateType`
+    std::atomic<PipelineStatus> status_{PipelineStatus::PENDING};
+    bool is_async_ = false;
+    std::optional<State> pending_state_;
+    uxs::inline_dynarray<util::ref_ptr<ShaderModule>> pending_modules_;
+
+    void setDynamicStateMask(const State& state);
+    bool compile(const State& state);
+    Device::ObjectKey makeLibraryKey(const State& state, VkGraphicsPipelineLibraryFlagBitsEXT part) const;
+    bool createLibraries(const State& state, const VkGraphicsPipelineCreateInfo& create_info);
+    bool link(bool optimize, VkPipeline& pipeline);
+    bool createShaders(const State& state);
 };
 
 }  // namespace app3d::rel::vulkan
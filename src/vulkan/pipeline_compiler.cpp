@@ -0,0 +1,68 @@
+#include "pipeline_compiler.h"
+
+#include "pipeline.h"
+
+#include <algorithm>
+
+using namespace app3d;
+using namespace app3d::rel;
+using namespace app3d::rel::vulkan;
+
+// --------------------------------------------------------
+// PipelineCompiler class implementation
+
+void PipelineCompiler::destroy() {
+    {
+        std::lock_guard lk(mtx_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& worker : workers_) { worker.join(); }
+    workers_.clear();
+    stop_ = false;
+}
+
+void PipelineCompiler::enqueue(Pipeline& pipeline) {
+    {
+        std::lock_guard lk(mtx_);
+        if (workers_.empty()) {
+            workers_.reserve(thread_count_);
+            for (std::uint32_t n = 0; n < thread_count_; ++n) { workers_.emplace_back([this]() { run(); }); }
+        }
+        queue_.push_back(&pipeline);
+    }
+    queue_cv_.notify_one();
+}
+
+void PipelineCompiler::cancel(Pipeline& pipeline) {
+    std::unique_lock lk(mtx_);
+    if (auto it = std::ranges::find(queue_, &pipeline); it != queue_.end()) { queue_.erase(it); }
+    done_cv_.wait(lk, [this, &pipeline]() { return std::ranges::find(in_progress_, &pipeline) == in_progress_.end(); });
+}
+
+void PipelineCompiler::wait(Pipeline& pipeline) {
+    std::unique_lock lk(mtx_);
+    done_cv_.wait(lk, [this, &pipeline]() {
+        return std::ranges::find(queue_, &pipeline) == queue_.end() &&
+               std::ranges::find(in_progress_, &pipeline) == in_progress_.end();
+    });
+}
+
+void PipelineCompiler::run() {
+    std::unique_lock lk(mtx_);
+    while (true) {
+        queue_cv_.wait(lk, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) { return; }
+
+        auto* pipeline = queue_.front();
+        queue_.pop_front();
+        in_progress_.push_back(pipeline);
+
+        lk.unlock();
+        pipeline->compilePending();
+        lk.lock();
+
+        in_progress_.erase(std::ranges::find(in_progress_, pipeline));
+        done_cv_.notify_all();
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace app3d::rel::vulkan {
+
+class Pipeline;
+
+// Worker threads compiling pipelines created with `createPipelineAsync` and linking optimized pipelines from
+// libraries: queued pipelines aren't referenced, a pipeline being destroyed is removed from the queue or waited for
+class PipelineCompiler {
+ public:
+    PipelineCompiler() = default;
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    ~PipelineCompiler() { destroy(); }
+
+    // Worker threads are started on first use
+    void create(std::uint32_t thread_count) { thread_count_ = std::max(thread_count, 1u); }
+    void destroy();
+
+    void enqueue(Pipeline& pipeline);
+    // Removes the pipeline from the queue and waits until its compilation is finished
+    void cancel(Pipeline& pipeline);
+    // Waits until the pipeline is compiled
+    void wait(Pipeline& pipeline);
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable queue_cv_;
+    std::condition_variable done_cv_;
+    std::deque<Pipeline*> queue_;
+    std::vector<Pipeline*> in_progress_;
+    bool stop_ = false;
+    std::uint32_t thread_count_ = 1;
+    std::vector<std::thread> workers_;
+
+    void run();
+};
+
+}  // namespace app3d::rel::vulkan
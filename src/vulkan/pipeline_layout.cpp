@@ -1,11 +1,14 @@
 #include "pipeline_layout.h"
 
 #include "descriptor_set.h"
+#include "descriptor_set_cache.h"
 #include "device.h"
 #include "pipeline.h"
 #include "render_target.h"
+#include "sampler.h"
 #include "shader_module.h"
 #include "tables.h"
+#include "texture.h"
 #include "vulkan_logger.h"
 
 #include "rel/tables.h"
@@ -20,12 +23,320 @@ using namespace app3d::rel::vulkan;
 PipelineLayout::PipelineLayout(Device& device) : device_(util::not_null(&device)) {}
 
 PipelineLayout::~PipelineLayout() {
-    device_->vkDestroyDescriptorPool(desc_pool_, nullptr);
-    device_->vkDestroyPipelineLayout(pipeline_layout_, nullptr);
-    for (const auto& set_layout : set_layouts_) { device_->vkDestroyDescriptorSetLayout(set_layout, nullptr); }
+    desc_allocator_.destroy();
+    for (const auto& update_template : update_templates_) {
+        device_->vkDestroyDescriptorUpdateTemplate(update_template.handle, nullptr);
+    }
+    device_->releasePipelineLayout(pipeline_layout_);
+    for (std::uint32_t n = 0; n < std::uint32_t(set_layouts_.size()); ++n) {
+        if (n != bindless_set_index_) { device_->releaseSetLayout(set_layouts_[n]); }
+    }
+}
+
+bool PipelineLayout::create(const uxs::db::value& config, std::span<ISampler* const> immutable_samplers) {
+    uxs::inline_dynarray<SetLayoutDesc, 4> set_layout_descs;
+    uxs::inline_dynarray<VkPushConstantRange> push_constant_ranges;
+
+    if (!readBindlessSetIndex(config)) { return false; }
+
+    const auto& descriptor_set_layouts = config.value("descriptor_set_layouts");
+
+    for (const auto& layout : descriptor_set_layouts.as_array()) {
+        auto& set_layout_desc = set_layout_descs.emplace_back();
+        set_layout_desc.max_sets = layout.value_or<std::uint32_t>("max_sets", 8);
+        set_layout_desc.push = layout.value<bool>("push");
+
+        const auto& list = layout.value("descriptor_list");
+
+        std::uint32_t def_binding = 0;
+
+        for (const auto& desc : list.as_array()) {
+            const std::uint32_t binding = desc.value_or<std::uint32_t>("binding", def_binding);
+            const auto type = parseDescriptorType(desc.value("type").as_string_view());
+            const std::uint32_t desc_count = desc.value_or<std::uint32_t>("count", 1);
+            const auto visibility = parseShaderStage(desc.value_or<const char*>("shader_visibility", "ALL"));
+            def_binding = binding + 1;
+
+            if (desc_count == 0) { continue; }
+
+            auto& descriptor_desc = set_layout_desc.descriptors.emplace_back(DescriptorDesc{
+                .type = type,
+                .binding = binding,
+                .count = desc_count,
+                .slot = desc.value_or<std::uint32_t>("slot", INVALID_UINT32_VALUE),
+                .sampler_slot = desc.value_or<std::uint32_t>("sampler_slot", INVALID_UINT32_VALUE),
+                .stage_flags = VkShaderStageFlags(TBL_VK_SHADER_STAGE[unsigned(visibility)]),
+                .immutable_sampler = nullptr,
+            });
+
+            if (!readImmutableSampler(desc.value("immutable_sampler"), immutable_samplers,
+                                      descriptor_desc.immutable_sampler)) {
+                return false;
+            }
+        }
+    }
+
+    if (!readPushConstantRanges(config, push_constant_ranges)) { return false; }
+
+    return createLayouts(set_layout_descs, push_constant_ranges);
+}
+
+bool PipelineLayout::create(std::span<IShaderModule* const> shader_modules, const uxs::db::value& config,
+                            std::span<ISampler* const> immutable_samplers) {
+    uxs::inline_dynarray<SetLayoutDesc, 4> set_layout_descs;
+    uxs::inline_dynarray<VkPushConstantRange> push_constant_ranges;
+
+    const std::uint32_t max_sets = config.value_or<std::uint32_t>("max_sets", 8);
+    const auto& push_sets = config.value("push_sets");
+
+    if (!readBindlessSetIndex(config)) { return false; }
+
+    // Merge descriptors of all shader stages: the same binding used by several stages becomes visible to all of them
+    for (const auto* module : shader_modules) {
+        if (!static_cast<const ShaderModule&>(*module).hasReflection()) {
+            logError(LOG_VK "couldn't create pipeline layout from shader module without reflection");
+            return false;
+        }
+
+        const auto& reflection = static_cast<const ShaderModule&>(*module).getReflection();
+        const auto stage_flags = VkShaderStageFlags(TBL_VK_SHADER_STAGE[unsigned(reflection.stage)]);
+
+        for (const auto& binding : reflection.descriptor_bindings) {
+            if (binding.set == bindless_set_index_) { continue; }  // provided by the global bindless set
+            if (binding.count == 0) {
+                logError(LOG_VK "unbounded descriptor array (binding {} of set {}) is not in the bindless set",
+                         binding.binding, binding.set);
+                return false;
+            }
+            while (binding.set >= set_layout_descs.size()) {
+                set_layout_descs.emplace_back().max_sets = max_sets;
+            }
+
+            auto& descriptors = set_layout_descs[binding.set].descriptors;
+            auto desc_it = std::ranges::find_if(
+                descriptors, [&binding](const auto& desc) { return desc.binding == binding.binding; });
+            if (desc_it == descriptors.end()) {
+                descriptors.emplace_back(DescriptorDesc{
+                    .type = binding.type,
+                    .binding = binding.binding,
+                    .count = binding.count,
+                    .slot = INVALID_UINT32_VALUE,
+                    .sampler_slot = INVALID_UINT32_VALUE,
+                    .stage_flags = stage_flags,
+                    .immutable_sampler = nullptr,
+                });
+                continue;
+            }
+
+            // Separate texture and sampler sharing the same binding are treated as combined texture-sampler
+            const auto is_texture_or_sampler = [](DescriptorType type) {
+                return type == DescriptorType::TEXTURE || type == DescriptorType::SAMPLER ||
+                       type == DescriptorType::COMBINED_TEXTURE_SAMPLER;
+            };
+
+            if (desc_it->type != binding.type) {
+                if (!is_texture_or_sampler(desc_it->type) || !is_texture_or_sampler(binding.type)) {
+                    logError(LOG_VK "conflicting descriptor types for binding {} of set {}", binding.binding,
+                             binding.set);
+                    return false;
+                }
+                desc_it->type = DescriptorType::COMBINED_TEXTURE_SAMPLER;
+            }
+
+            desc_it->count = std::max(binding.count, desc_it->count);
+            desc_it->stage_flags |= stage_flags;
+        }
+
+        // Stages using the same push constant range share it
+        if (reflection.push_constant_size != 0) {
+            auto range_it = std::ranges::find_if(push_constant_ranges, [&reflection](const auto& range) {
+                return range.offset == reflection.push_constant_offset && range.size == reflection.push_constant_size;
+            });
+            if (range_it != push_constant_ranges.end()) {
+                range_it->stageFlags |= stage_flags;
+            } else {
+                push_constant_ranges.emplace_back(VkPushConstantRange{
+                    .stageFlags = stage_flags,
+                    .offset = reflection.push_constant_offset,
+                    .size = reflection.push_constant_size,
+                });
+            }
+        }
+    }
+
+    // Reflected descriptor types can be refined, e.g. constant buffer can be made dynamic
+    for (const auto& desc_override : config.value("descriptor_overrides").as_array()) {
+        const std::uint32_t set = desc_override.value_or<std::uint32_t>("set", 0);
+        const std::uint32_t binding = desc_override.value<std::uint32_t>("binding");
+        if (set >= set_layout_descs.size()) { throw uxs::db::database_error("descriptor set index out of range"); }
+
+        auto& descriptors = set_layout_descs[set].descriptors;
+        auto desc_it = std::ranges::find_if(descriptors,
+                                            [binding](const auto& desc) { return desc.binding == binding; });
+        if (desc_it == descriptors.end()) { throw uxs::db::database_error("overridden descriptor is not used"); }
+
+        if (const auto& type = desc_override.value("type"); !type.is_null()) {
+            desc_it->type = parseDescriptorType(type.as_string_view());
+        }
+        desc_it->slot = desc_override.value_or<std::uint32_t>("slot", desc_it->slot);
+        desc_it->sampler_slot = desc_override.value_or<std::uint32_t>("sampler_slot", desc_it->sampler_slot);
+        if (!readImmutableSampler(desc_override.value("immutable_sampler"), immutable_samplers,
+                                  desc_it->immutable_sampler)) {
+            return false;
+        }
+    }
+
+    for (auto& set_layout_desc : set_layout_descs) {
+        std::ranges::sort(set_layout_desc.descriptors, {}, &DescriptorDesc::binding);
+    }
+
+    for (const auto& set : push_sets.as_array()) {
+        const std::uint32_t set_index = set.as<std::uint32_t>();
+        if (set_index >= set_layout_descs.size()) { throw uxs::db::database_error("push set index out of range"); }
+        set_layout_descs[set_index].push = true;
+    }
+
+    // Explicitly specified push constant ranges replace reflected ones
+    if (!readPushConstantRanges(config, push_constant_ranges)) { return false; }
+
+    return createLayouts(set_layout_descs, push_constant_ranges);
+}
+
+VkShaderStageFlags PipelineLayout::getPushConstantStages(std::uint32_t offset, std::uint32_t size) const {
+    VkShaderStageFlags stage_flags = 0;
+    for (const auto& range : push_constant_ranges_) {
+        if (offset < range.offset + range.size && range.offset < offset + size) { stage_flags |= range.stageFlags; }
+    }
+    return stage_flags;
+}
+
+bool PipelineLayout::isPushConstantUpdateValid(VkShaderStageFlags stage_flags, std::uint32_t offset,
+                                               std::uint32_t size) const {
+    // Each stage has at most one range, so the stage is valid, if its range contains the updated one
+    VkShaderStageFlags containing_stages = 0;
+    for (const auto& range : push_constant_ranges_) {
+        const bool overlaps = offset < range.offset + range.size && range.offset < offset + size;
+        if (overlaps && (range.stageFlags & ~stage_flags) != 0) { return false; }
+        if (range.offset <= offset && offset + size <= range.offset + range.size) {
+            containing_stages |= range.stageFlags;
+        }
+    }
+    return stage_flags != 0 && (stage_flags & ~containing_stages) == 0;
+}
+
+void PipelineLayout::makeDescriptorInfos(const UpdateTemplate& update_template,
+                                         std::span<const DescriptorData> descriptors,
+                                         std::span<DescriptorInfo> desc_infos) {
+    assert(descriptors.size() == update_template.desc_types.size() && desc_infos.size() == descriptors.size());
+
+    for (std::size_t n = 0; n < descriptors.size(); ++n) {
+        const auto& data = descriptors[n];
+        auto& desc_info = desc_infos[n];
+        switch (update_template.desc_types[n]) {
+            case DescriptorType::SAMPLER: {
+                desc_info.image = VkDescriptorImageInfo{.sampler = static_cast<Sampler&>(*data.sampler).getHandle()};
+            } break;
+            case DescriptorType::COMBINED_TEXTURE_SAMPLER: {
+                // Sampler can be omitted, if it is immutable
+                desc_info.image = VkDescriptorImageInfo{
+                    .sampler = data.sampler ? static_cast<Sampler&>(*data.sampler).getHandle() : VK_NULL_HANDLE,
+                    .imageView = static_cast<Texture&>(*data.texture).getImageView(0),
+                    .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                };
+            } break;
+            case DescriptorType::TEXTURE: {
+                desc_info.image = VkDescriptorImageInfo{
+                    .imageView = static_cast<Texture&>(*data.texture).getImageView(0),
+                    .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                };
+            } break;
+            case DescriptorType::RW_TEXTURE: {
+                desc_info.image = VkDescriptorImageInfo{
+                    .imageView = static_cast<Texture&>(*data.texture).getImageView(0),
+                    .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+                };
+            } break;
+            default: {
+                auto& buffer = static_cast<Buffer&>(*data.buffer);
+                desc_info.buffer = VkDescriptorBufferInfo{
+                    .buffer = buffer.getHandle(),
+                    .offset = VkDeviceSize(data.offset),
+                    .range = buffer.getRange(data.offset, data.size),
+                };
+            } break;
+        }
+    }
+}
+
+bool PipelineLayout::obtainDescriptorSet(std::uint32_t set_layout_index, DescriptorSetHandle& handle) {
+    // Sets stored in descriptor buffers have no handles: their data is kept by set objects
+    if (device_->useDescriptorBuffer()) {
+        handle = DescriptorSetHandle{
+            .binding_offsets = &binding_offsets_[set_layout_index],
+            .handle = VK_NULL_HANDLE,
+            .set_layout_index = set_layout_index,
+            .pool_index = INVALID_UINT32_VALUE,
+            .pool_generation = 0,
+        };
+        return true;
+    }
+
+    DescriptorAllocator::Allocation allocation{};
+    // Pools of the layout are sized for all its sets already
+    if (!desc_allocator_.allocate(set_layouts_[set_layout_index], {}, allocation)) { return false; }
+    handle.binding_offsets = &binding_offsets_[set_layout_index];
+    handle.handle = allocation.handle;
+    handle.set_layout_index = set_layout_index;
+    handle.pool_index = allocation.pool_index;
+    handle.pool_generation = allocation.pool_generation;
+    return true;
+}
+
+void PipelineLayout::releaseDescriptorSet(const DescriptorSetHandle& handle) {
+    if (handle.handle == VK_NULL_HANDLE || handle.pool_index == INVALID_UINT32_VALUE) { return; }
+    desc_allocator_.free(DescriptorAllocator::Allocation{
+        .handle = handle.handle,
+        .pool_index = handle.pool_index,
+        .pool_generation = handle.pool_generation,
+    });
+}
+
+bool PipelineLayout::isDescriptorSetValid(const DescriptorSetHandle& handle) const {
+    if (handle.handle == VK_NULL_HANDLE || handle.pool_index == INVALID_UINT32_VALUE) { return true; }
+    return desc_allocator_.isAllocationValid(DescriptorAllocator::Allocation{
+        .handle = handle.handle,
+        .pool_index = handle.pool_index,
+        .pool_generation = handle.pool_generation,
+    });
+}
+
+//@{ IPipelineLayout
+
+util::ref_ptr<IDescriptorSet> PipelineLayout::createDescriptorSet(std::uint32_t set_layout_index) {
+    if (update_templates_[set_layout_index].is_push) {
+        logError(LOG_VK "descriptor set can't be created for push descriptor set layout");
+        return nullptr;
+    }
+    auto descriptor_set = util::make_new<DescriptorSet>(*device_, *this);
+    if (!descriptor_set->create(set_layout_index)) { return nullptr; }
+    return std::move(descriptor_set);
+}
+
+IDescriptorSet* PipelineLayout::createTransientDescriptorSet(IRenderTarget& render_target,
+                                                             std::uint32_t set_layout_index) {
+    return static_cast<RenderTarget&>(render_target).obtainTransientDescriptorSet(*this, set_layout_index);
+}
+
+void PipelineLayout::resetDescriptorAllocator() { desc_allocator_.reset(); }
+
+util::ref_ptr<IDescriptorSetCache> PipelineLayout::createDescriptorSetCache(std::uint32_t max_unused_frames) {
+    return util::make_new<DescriptorSetCache>(*device_, *this, max_unused_frames);
 }
 
-bool PipelineLayout::create(const uxs::db::value& config) {
+//@}
+
+bool PipelineLayout::createLayouts(std::span<const SetLayoutDesc> set_layout_descs,
+                                   std::span<const VkPushConstantRange> push_constant_ranges) {
     struct BindingRange {
         std::uint32_t slot;
         std::uint32_t count;
@@ -35,65 +346,142 @@ bool PipelineLayout::create(const uxs::db::value& config) {
     std::uint32_t total_max_sets = 0;
     uxs::inline_dynarray<VkDescriptorPoolSize> desc_counts;
     uxs::inline_dynarray<VkDescriptorSetLayoutBinding> vk_bindings;
+    uxs::inline_dynarray<VkSampler, 16> immutable_sampler_handles;
     PerBindingType<uxs::inline_dynarray<BindingRange, 32>> binding_ranges;
 
-    const auto& descriptor_set_layouts = config.value("descriptor_set_layouts");
+    // The set layout at bindless set index is replaced by the global one
+    const std::size_t set_count = bindless_set_index_ != INVALID_UINT32_VALUE ?
+                                      std::max<std::size_t>(set_layout_descs.size(), bindless_set_index_ + 1) :
+                                      set_layout_descs.size();
+
+    // Sets between declared ones and the bindless set have empty layouts
+    const SetLayoutDesc empty_layout{.max_sets = 0};
+
+    for (std::uint32_t set_index = 0; set_index < std::uint32_t(set_count); ++set_index) {
+        if (set_index == bindless_set_index_) {
+            set_layouts_.push_back(device_->getBindlessHeap().getSetLayout());
+            set_desc_counts_.emplace_back();
+            binding_offsets_.emplace_back();
+            update_templates_.emplace_back();
+            continue;
+        }
 
-    for (const auto& layout : descriptor_set_layouts.as_array()) {
-        const std::uint32_t max_sets = layout.value_or<std::uint32_t>("max_sets", 8);
-        total_max_sets += max_sets;
+        const auto& layout = set_index < set_layout_descs.size() ? set_layout_descs[set_index] : empty_layout;
+        const std::uint32_t max_sets = layout.max_sets;
 
-        const auto& list = layout.value("descriptor_list");
+        if (layout.push && !device_->isExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+            logError(LOG_VK "push descriptors are not supported");
+            return false;
+        }
+
+        if (layout.push && device_->useDescriptorBuffer()) {
+            logError(LOG_VK "push descriptors can't be used together with descriptor buffers");
+            return false;
+        }
+
+        if (layout.push) {
+            std::uint32_t total_desc_count = 0;
+            for (const auto& desc : layout.descriptors) {
+                const auto vk_type = TBL_VK_DESC_TYPE[unsigned(desc.type)];
+                if (vk_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                    vk_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) {
+                    logError(LOG_VK "dynamic descriptor of binding {} can't be pushed", desc.binding);
+                    return false;
+                }
+                total_desc_count += desc.count;
+            }
+            const std::uint32_t max_push_descriptors =
+                device_->getPhysicalDevice().getPushDescriptorProperties().maxPushDescriptors;
+            if (total_desc_count > max_push_descriptors) {
+                logError(LOG_VK "push descriptor set exceeds {} descriptors limit", max_push_descriptors);
+                return false;
+            }
+        }
+
+        // Push descriptor sets and sets stored in descriptor buffers are not allocated from pools
+        const bool use_pool = !layout.push && !device_->useDescriptorBuffer();
+        if (use_pool) { total_max_sets += max_sets; }
 
         vk_bindings.clear();
         for (auto& range : binding_ranges) { range.clear(); }
 
-        std::uint32_t def_binding = 0;
+        auto& set_desc_counts = set_desc_counts_.emplace_back();
+
+        // Immutable samplers are gathered beforehand, so pointers to them remain valid
+        immutable_sampler_handles.clear();
+        for (const auto& desc : layout.descriptors) {
+            if (!desc.immutable_sampler) { continue; }
+            if (desc.type != DescriptorType::SAMPLER && desc.type != DescriptorType::COMBINED_TEXTURE_SAMPLER) {
+                logError(LOG_VK "immutable sampler is specified for binding {} without samplers", desc.binding);
+                return false;
+            }
+            if (device_->useDescriptorBuffer()) {
+                logError(LOG_VK "immutable samplers can't be used together with descriptor buffers");
+                return false;
+            }
+            immutable_sampler_handles.insert(immutable_sampler_handles.end(), desc.count,
+                                             static_cast<Sampler&>(*desc.immutable_sampler).getHandle());
+        }
+
+        const VkSampler* immutable_sampler_handle = immutable_sampler_handles.data();
+
         PerBindingType<std::uint32_t> next_slots{};
 
-        for (const auto& desc : list.as_array()) {
-            const std::uint32_t binding = desc.value_or<std::uint32_t>("binding", def_binding);
-            const auto type = parseDescriptorType(desc.value("type").as_string_view());
+        for (const auto& desc : layout.descriptors) {
+            const auto type = desc.type;
+            const std::uint32_t binding = desc.binding;
+            const std::uint32_t desc_count = desc.count;
             const auto binding_type = TBL_DESC_BINDING_TYPE[unsigned(type)];
             const auto vk_type = TBL_VK_DESC_TYPE[unsigned(type)];
-            const std::uint32_t slot = desc.value_or<std::uint32_t>("slot", next_slots[unsigned(binding_type)]);
-            const std::uint32_t desc_count = desc.value_or<std::uint32_t>("count", 1);
-            const auto visibility = parseShaderStage(desc.value_or<const char*>("shader_visibility", "ALL"));
-            def_binding = binding + 1;
 
-            if (desc_count == 0) { continue; }
+            // Descriptor buffers have no dynamic offsets, and texel buffer views aren't supported
+            const bool is_texel_or_dynamic = type == DescriptorType::BUFFER || type == DescriptorType::RW_BUFFER ||
+                                             vk_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                                             vk_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            if (is_texel_or_dynamic && device_->useDescriptorBuffer()) {
+                logError(LOG_VK "descriptor type of binding {} can't be stored in descriptor buffer", binding);
+                return false;
+            }
 
-            const auto add_binding_range = [&binding_ranges, &next_slots, type, binding, desc_count](auto binding_type,
-                                                                                                     auto slot) {
+            const std::uint32_t encoded_binding = (binding << 8) | (desc.immutable_sampler ? 128 : 0) |
+                                                  std::uint32_t(type);
+            const auto add_binding_range = [&binding_ranges, &next_slots, desc_count, encoded_binding](
+                                               auto binding_type, auto slot) {
+                if (slot == INVALID_UINT32_VALUE) { slot = next_slots[unsigned(binding_type)]; }
                 binding_ranges[unsigned(binding_type)].emplace_back(
-                    BindingRange{.slot = slot, .count = desc_count, .binding = (binding << 8) | std::uint32_t(type)});
+                    BindingRange{.slot = slot, .count = desc_count, .binding = encoded_binding});
                 next_slots[unsigned(binding_type)] = slot + desc_count;
             };
 
-            add_binding_range(binding_type, slot);
+            add_binding_range(binding_type, desc.slot);
             if (type == DescriptorType::COMBINED_TEXTURE_SAMPLER) {
-                const std::uint32_t sampler_slot = desc.value_or<std::uint32_t>(
-                    "sampler_slot", next_slots[unsigned(BindingType::SAMPLER)]);
-                add_binding_range(BindingType::SAMPLER, sampler_slot);
+                add_binding_range(BindingType::SAMPLER, desc.sampler_slot);
             }
 
             vk_bindings.emplace_back(VkDescriptorSetLayoutBinding{
                 .binding = binding,
                 .descriptorType = vk_type,
                 .descriptorCount = desc_count,
-                .stageFlags = VkShaderStageFlags(TBL_VK_SHADER_STAGE[unsigned(visibility)]),
+                .stageFlags = desc.stage_flags,
+                .pImmutableSamplers = desc.immutable_sampler ? immutable_sampler_handle : nullptr,
             });
 
-            auto desc_counts_it = std::ranges::find_if(desc_counts,
-                                                       [vk_type](const auto& item) { return item.type == vk_type; });
-            if (desc_counts_it != desc_counts.end()) {
-                desc_counts_it->descriptorCount += max_sets * desc_count;
-            } else {
-                desc_counts.emplace_back(VkDescriptorPoolSize{
-                    .type = vk_type,
-                    .descriptorCount = max_sets * desc_count,
-                });
-            }
+            if (desc.immutable_sampler) { immutable_sampler_handle += desc_count; }
+
+            if (!use_pool) { continue; }
+
+            const auto add_desc_count = [vk_type](auto& desc_counts, std::uint32_t count) {
+                auto it = std::ranges::find_if(desc_counts,
+                                               [vk_type](const auto& item) { return item.type == vk_type; });
+                if (it != desc_counts.end()) {
+                    it->descriptorCount += count;
+                } else {
+                    desc_counts.emplace_back(VkDescriptorPoolSize{.type = vk_type, .descriptorCount = count});
+                }
+            };
+
+            add_desc_count(set_desc_counts, desc_count);
+            add_desc_count(desc_counts, max_sets * desc_count);
         }
 
         auto& binding_offsets = binding_offsets_.emplace_back();
@@ -105,80 +493,175 @@ bool PipelineLayout::create(const uxs::db::value& config) {
             }
         }
 
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+        if (layout.push) { flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR; }
+        if (device_->useDescriptorBuffer()) { flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT; }
+
         const VkDescriptorSetLayoutCreateInfo create_info{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .flags = flags,
             .bindingCount = std::uint32_t(vk_bindings.size()),
             .pBindings = vk_bindings.data(),
         };
 
-        VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
-        VkResult result = device_->vkCreateDescriptorSetLayout(&create_info, nullptr, &set_layout);
-        if (result != VK_SUCCESS) {
-            logError(LOG_VK "couldn't create layout for descriptor sets: {}", result);
-            return false;
-        }
+        const VkDescriptorSetLayout set_layout = device_->obtainSetLayout(create_info);
+        if (set_layout == VK_NULL_HANDLE) { return false; }
 
         set_layouts_.push_back(set_layout);
+
+        if (!createUpdateTemplate(std::uint32_t(set_layouts_.size() - 1), layout)) { return false; }
     }
 
+    const std::uint32_t max_push_constants_size =
+        device_->getPhysicalDevice().getProperties().limits.maxPushConstantsSize;
+    for (const auto& range : push_constant_ranges) {
+        if (range.offset + range.size > max_push_constants_size) {
+            logError(LOG_VK "push constant range exceeds {} bytes limit", max_push_constants_size);
+            return false;
+        }
+    }
+
+    push_constant_ranges_.assign(push_constant_ranges.begin(), push_constant_ranges.end());
+
     const VkPipelineLayoutCreateInfo create_info{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .setLayoutCount = std::uint32_t(set_layouts_.size()),
         .pSetLayouts = set_layouts_.data(),
+        .pushConstantRangeCount = std::uint32_t(push_constant_ranges.size()),
+        .pPushConstantRanges = push_constant_ranges.data(),
     };
 
-    VkResult result = device_->vkCreatePipelineLayout(&create_info, nullptr, &pipeline_layout_);
-    if (result != VK_SUCCESS) {
-        logError(LOG_VK "couldn't create pipeline layout: {}", result);
+    pipeline_layout_ = device_->obtainPipelineLayout(create_info);
+    if (pipeline_layout_ == VK_NULL_HANDLE) { return false; }
+
+    if (total_max_sets == 0) { return true; }  // no sets to allocate
+
+    desc_allocator_.create(*device_, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, total_max_sets, desc_counts);
+    return true;
+}
+
+bool PipelineLayout::readBindlessSetIndex(const uxs::db::value& config) {
+    bindless_set_index_ = config.value_or<std::uint32_t>("bindless_set", INVALID_UINT32_VALUE);
+    if (bindless_set_index_ != INVALID_UINT32_VALUE && !device_->getBindlessHeap().isCreated()) {
+        logError(LOG_VK "bindless set is used, but bindless mode is not enabled for the device");
         return false;
     }
-
-    return createDescriptorPool(total_max_sets, desc_counts);
+    return true;
 }
 
-bool PipelineLayout::obtainDescriptorSet(std::uint32_t set_layout_index, DescriptorSetHandle& handle) {
-    const VkDescriptorSetAllocateInfo allocate_info{
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .descriptorPool = desc_pool_,
-        .descriptorSetCount = 1,
-        .pSetLayouts = &set_layouts_[set_layout_index],
-    };
+bool PipelineLayout::readImmutableSampler(const uxs::db::value& sampler, std::span<ISampler* const> immutable_samplers,
+                                          ISampler*& immutable_sampler) {
+    if (sampler.is_null()) { return true; }
 
-    VkResult result = device_->vkAllocateDescriptorSets(&allocate_info, &handle.handle);
-    if (result != VK_SUCCESS) {
-        logError(LOG_VK "couldn't allocate descriptor sets: {}", result);
-        return false;
+    // Immutable sampler is either referenced by index or described inline
+    if (!sampler.is_record()) {
+        const std::uint32_t index = sampler.as<std::uint32_t>();
+        if (index >= immutable_samplers.size()) {
+            throw uxs::db::database_error("immutable sampler index out of range");
+        }
+        immutable_sampler = immutable_samplers_.emplace_back(immutable_samplers[index]).get();
+        return true;
     }
 
-    handle.binding_offsets = &binding_offsets_[set_layout_index];
+    const SamplerDesc desc{
+        .filter = parseSamplerFilter(sampler.value_or<const char*>("filter", "MIN_MAG_MIP_LINEAR")),
+        .address_mode_u = parseSamplerAddressMode(sampler.value_or<const char*>("address_mode_u", "REPEAT")),
+        .address_mode_v = parseSamplerAddressMode(sampler.value_or<const char*>("address_mode_v", "REPEAT")),
+        .address_mode_w = parseSamplerAddressMode(sampler.value_or<const char*>("address_mode_w", "REPEAT")),
+        .min_lod = sampler.value_or<float>("min_lod", 0.f),
+        .max_lod = sampler.value_or<float>("max_lod", VK_LOD_CLAMP_NONE),
+        .mip_lod_bias = sampler.value_or<float>("mip_lod_bias", 0.f),
+        .max_anisotropy = sampler.value_or<std::uint32_t>("max_anisotropy", 1),
+    };
+
+    auto inline_sampler = device_->createSampler(desc);
+    if (!inline_sampler) { return false; }
+    immutable_sampler = immutable_samplers_.emplace_back(std::move(inline_sampler)).get();
     return true;
 }
 
-//@{ IPipelineLayout
+bool PipelineLayout::readPushConstantRanges(const uxs::db::value& config,
+                                            uxs::inline_dynarray<VkPushConstantRange>& push_constant_ranges) {
+    const auto& ranges = config.value("push_constant_ranges");
+    if (ranges.is_null()) { return true; }
+
+    push_constant_ranges.clear();
+    for (const auto& range : ranges.as_array()) {
+        const std::uint32_t offset = range.value_or<std::uint32_t>("offset", 0);
+        const std::uint32_t size = range.value<std::uint32_t>("size");
+        if (offset % 4 != 0 || size % 4 != 0 || size == 0) {
+            throw uxs::db::database_error("push constant offset and size must be non-zero multiples of 4");
+        }
+        const auto visibility = parseShaderStage(range.value_or<const char*>("shader_visibility", "ALL"));
+        const auto stage_flags = VkShaderStageFlags(TBL_VK_SHADER_STAGE[unsigned(visibility)]);
+        if (std::ranges::any_of(push_constant_ranges,
+                                [stage_flags](const auto& item) { return (item.stageFlags & stage_flags) != 0; })) {
+            logError(LOG_VK "push constant ranges must have different shader stages");
+            return false;
+        }
+        push_constant_ranges.emplace_back(VkPushConstantRange{
+            .stageFlags = stage_flags,
+            .offset = offset,
+            .size = size,
+        });
+    }
 
-util::ref_ptr<IDescriptorSet> PipelineLayout::createDescriptorSet(std::uint32_t set_layout_index) {
-    auto descriptor_set = util::make_new<DescriptorSet>(*device_, *this);
-    if (!descriptor_set->create(set_layout_index)) { return nullptr; }
-    return std::move(descriptor_set);
+    return true;
 }
 
-void PipelineLayout::resetDescriptorAllocator() { device_->vkResetDescriptorPool(desc_pool_, 0); }
+bool PipelineLayout::createUpdateTemplate(std::uint32_t set_layout_index, const SetLayoutDesc& layout) {
+    auto& update_template = update_templates_.emplace_back();
+    update_template.is_push = layout.push;
 
-//@}
+    auto& entries = update_template.entries;
+
+    for (const auto& desc : layout.descriptors) {
+        // Sampler descriptors with immutable samplers are never written
+        if (desc.type == DescriptorType::SAMPLER && desc.immutable_sampler) { continue; }
+
+        // Texel buffers are written with buffer views, which aren't supported by template data
+        if (desc.type == DescriptorType::BUFFER || desc.type == DescriptorType::RW_BUFFER) {
+            update_template.has_texel_buffers = true;
+            return true;
+        }
+
+        entries.emplace_back(VkDescriptorUpdateTemplateEntry{
+            .dstBinding = desc.binding,
+            .dstArrayElement = 0,
+            .descriptorCount = desc.count,
+            .descriptorType = TBL_VK_DESC_TYPE[unsigned(desc.type)],
+            .offset = update_template.desc_types.size() * sizeof(DescriptorInfo),
+            .stride = sizeof(DescriptorInfo),
+        });
+
+        update_template.desc_types.insert(update_template.desc_types.end(), desc.count, desc.type);
+    }
+
+    // Descriptor data is written to binding offsets of the set in descriptor buffer instead of using templates
+    if (device_->useDescriptorBuffer()) {
+        const auto set_layout = set_layouts_[set_layout_index];
+        device_->vkGetDescriptorSetLayoutSizeEXT(set_layout, &update_template.desc_buffer_size);
+        for (const auto& entry : entries) {
+            device_->vkGetDescriptorSetLayoutBindingOffsetEXT(set_layout, entry.dstBinding,
+                                                              &update_template.desc_buffer_offsets.emplace_back());
+        }
+        return true;
+    }
+
+    // Push descriptors are written directly to command buffer
+    if (entries.empty() || layout.push) { return true; }
 
-bool PipelineLayout::createDescriptorPool(std::uint32_t total_max_sets,
-                                          std::span<const VkDescriptorPoolSize> desc_counts) {
-    const VkDescriptorPoolCreateInfo create_info{
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
-        .maxSets = total_max_sets,
-        .poolSizeCount = std::uint32_t(desc_counts.size()),
-        .pPoolSizes = desc_counts.data(),
+    const VkDescriptorUpdateTemplateCreateInfo create_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = std::uint32_t(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+        .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+        .descriptorSetLayout = set_layouts_[set_layout_index],
     };
 
-    VkResult result = device_->vkCreateDescriptorPool(&create_info, nullptr, &desc_pool_);
+    VkResult result = device_->vkCreateDescriptorUpdateTemplate(&create_info, nullptr, &update_template.handle);
     if (result != VK_SUCCESS) {
-        logError(LOG_VK "couldn't create descriptor pool: {}", result);
+        logError(LOG_VK "couldn't create descriptor update template: {}", result);
         return false;
     }
 
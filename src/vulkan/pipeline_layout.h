@@ -1,7 +1,8 @@
 #pragma once
 
-#include "vulkan_api.h"
+#include "descriptor_allocator.h"
 
+#include "common/core_defs.h"
 #include "interfaces/i_rendering_driver.h"
 
 #include <uxs/dynarray.h>
@@ -22,6 +23,7 @@ class PipelineLayout : public util::ref_counter, public IPipelineLayout {
 
     struct Binding {
         DescriptorType desc_type;
+        bool has_immutable_sampler;
         std::uint32_t binding;
         std::uint32_t array_element;
     };
@@ -29,6 +31,45 @@ class PipelineLayout : public util::ref_counter, public IPipelineLayout {
     struct DescriptorSetHandle {
         const PerBindingType<std::uint32_t>* binding_offsets;
         VkDescriptorSet handle;
+        std::uint32_t set_layout_index;
+        std::uint32_t pool_index;  // `INVALID_UINT32_VALUE` - transient set, which isn't freed separately
+        std::uint32_t pool_generation;
+    };
+
+    struct DescriptorDesc {
+        DescriptorType type;
+        std::uint32_t binding;
+        std::uint32_t count;
+        std::uint32_t slot;          // `INVALID_UINT32_VALUE` - next free slot
+        std::uint32_t sampler_slot;  // `INVALID_UINT32_VALUE` - next free slot
+        VkShaderStageFlags stage_flags;
+        ISampler* immutable_sampler;  // used for all array elements
+    };
+
+    struct SetLayoutDesc {
+        std::uint32_t max_sets;
+        bool push = false;
+        uxs::inline_dynarray<DescriptorDesc, 16> descriptors;
+    };
+
+    // Element of descriptor update template data
+    union DescriptorInfo {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+    };
+
+    // Array of infos is also used as `pImageInfo` or `pBufferInfo` of descriptor writes
+    static_assert(sizeof(DescriptorInfo) == sizeof(VkDescriptorImageInfo) &&
+                  sizeof(DescriptorInfo) == sizeof(VkDescriptorBufferInfo));
+
+    struct UpdateTemplate {
+        VkDescriptorUpdateTemplate handle{VK_NULL_HANDLE};
+        bool is_push = false;
+        bool has_texel_buffers = false;
+        uxs::inline_dynarray<VkDescriptorUpdateTemplateEntry, 8> entries;
+        uxs::inline_dynarray<DescriptorType, 16> desc_types;        // for each descriptor array element
+        VkDeviceSize desc_buffer_size = 0;                          // size of set data in descriptor buffer
+        uxs::inline_dynarray<VkDeviceSize, 8> desc_buffer_offsets;  // for each entry
     };
 
     Binding getBinding(const PerBindingType<std::uint32_t>& offsets, BindingType binding_type,
@@ -37,33 +78,75 @@ class PipelineLayout : public util::ref_counter, public IPipelineLayout {
         std::uint32_t array_element = 0;
         if (*binding < 0) { binding += *binding, array_element = std::uint32_t(-*binding); }
         return Binding{
-            .desc_type = DescriptorType(*binding & 255),  // 0:7 - descriptor type
-            .binding = std::uint32_t(*binding >> 8),      // 8:30 - descriptor binding
+            .desc_type = DescriptorType(*binding & 127),     // 0:6 - descriptor type
+            .has_immutable_sampler = (*binding & 128) != 0,  // 7 - binding has immutable samplers
+            .binding = std::uint32_t(*binding >> 8),         // 8:30 - descriptor binding
             .array_element = array_element,
         };
     }
 
-    bool create(const uxs::db::value& config);
+    bool create(const uxs::db::value& config, std::span<ISampler* const> immutable_samplers);
+    bool create(std::span<IShaderModule* const> shader_modules, const uxs::db::value& config,
+                std::span<ISampler* const> immutable_samplers);
     bool obtainDescriptorSet(std::uint32_t set_layout_index, DescriptorSetHandle& handle);
+    void releaseDescriptorSet(const DescriptorSetHandle& handle);
+    // Set becomes invalid, when the descriptor allocator is reset
+    bool isDescriptorSetValid(const DescriptorSetHandle& handle) const;
 
     VkPipelineLayout getHandle() { return pipeline_layout_; }
+    std::uint32_t getBindlessSetIndex() const { return bindless_set_index_; }
+    // Stages of all push constant ranges overlapping the given one
+    VkShaderStageFlags getPushConstantStages(std::uint32_t offset, std::uint32_t size) const;
+    // Each of the stages must have a range containing the updated one, and all stages of overlapping ranges must be
+    // specified
+    bool isPushConstantUpdateValid(VkShaderStageFlags stage_flags, std::uint32_t offset, std::uint32_t size) const;
+    VkDescriptorSetLayout getSetLayout(std::uint32_t set_layout_index) { return set_layouts_[set_layout_index]; }
+    // Descriptor counts of one set allocated from descriptor pools, empty for sets, which aren't allocated
+    std::span<const VkDescriptorPoolSize> getSetDescCounts(std::uint32_t set_layout_index) const {
+        return set_desc_counts_[set_layout_index];
+    }
+    std::span<const VkDescriptorSetLayout> getSetLayouts() const { return set_layouts_; }
+    std::span<const VkPushConstantRange> getPushConstantRanges() const { return push_constant_ranges_; }
+    const PerBindingType<std::uint32_t>& getBindingOffsets(std::uint32_t set_layout_index) const {
+        return binding_offsets_[set_layout_index];
+    }
+    const UpdateTemplate& getUpdateTemplate(std::uint32_t set_layout_index) const {
+        return update_templates_[set_layout_index];
+    }
+    static void makeDescriptorInfos(const UpdateTemplate& update_template, std::span<const DescriptorData> descriptors,
+                                    std::span<DescriptorInfo> desc_infos);
 
     //@{ IPipelineLayout
     util::ref_counter& getRefCounter() override { return *this; }
     util::ref_ptr<IDescriptorSet> createDescriptorSet(std::uint32_t set_layout_index) override;
+    IDescriptorSet* createTransientDescriptorSet(IRenderTarget& render_target,
+                                                 std::uint32_t set_layout_index) override;
     void resetDescriptorAllocator() override;
+    util::ref_ptr<IDescriptorSetCache> createDescriptorSetCache(std::uint32_t max_unused_frames) override;
     //@}
 
  private:
     util::ref_ptr<Device> device_;
     VkPipelineLayout pipeline_layout_{VK_NULL_HANDLE};
-    VkDescriptorPool desc_pool_{VK_NULL_HANDLE};
+    DescriptorAllocator desc_allocator_;
+    std::uint32_t bindless_set_index_ = INVALID_UINT32_VALUE;
 
     uxs::inline_dynarray<VkDescriptorSetLayout> set_layouts_;
+    uxs::inline_dynarray<uxs::inline_dynarray<VkDescriptorPoolSize, 4>> set_desc_counts_;
     uxs::inline_dynarray<PerBindingType<std::uint32_t>> binding_offsets_;
     uxs::inline_dynarray<std::int32_t, 64> bindings_;
-
-    bool createDescriptorPool(std::uint32_t total_max_sets, std::span<const VkDescriptorPoolSize> desc_counts);
+    uxs::inline_dynarray<UpdateTemplate> update_templates_;
+    uxs::inline_dynarray<VkPushConstantRange> push_constant_ranges_;
+    uxs::inline_dynarray<util::ref_ptr<ISampler>> immutable_samplers_;  // must outlive layouts
+
+    bool createLayouts(std::span<const SetLayoutDesc> set_layout_descs,
+                       std::span<const VkPushConstantRange> push_constant_ranges);
+    bool readBindlessSetIndex(const uxs::db::value& config);
+    bool readImmutableSampler(const uxs::db::value& sampler, std::span<ISampler* const> immutable_samplers,
+                              ISampler*& immutable_sampler);
+    static bool readPushConstantRanges(const uxs::db::value& config,
+                                       uxs::inline_dynarray<VkPushConstantRange>& push_constant_ranges);
+    bool createUpdateTemplate(std::uint32_t set_layout_index, const SetLayoutDesc& layout);
 };
 
 }  // namespace app3d::rel::vulkan
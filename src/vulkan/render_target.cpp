@@ -8,10 +8,28 @@
 #include "vulkan_logger.h"
 #include "wrappers.h"
 
+#include <algorithm>
+
 using namespace app3d;
 using namespace app3d::rel;
 using namespace app3d::rel::vulkan;
 
+namespace {
+// Sets of any layout are allocated from transient descriptor pools, so pool sizes grow to fit layouts in use
+constexpr std::uint32_t TRANSIENT_DESC_POOL_MAX_SETS = 256;
+
+// Packets with the same state and instance range can be drawn with one command
+bool isSameDrawState(const DrawPacket& lhs, const DrawPacket& rhs) {
+    return lhs.pipeline == rhs.pipeline && lhs.vertex_buffer == rhs.vertex_buffer &&
+           lhs.vertex_stride == rhs.vertex_stride && lhs.vertex_offset == rhs.vertex_offset &&
+           lhs.index_buffer == rhs.index_buffer && lhs.index_offset == rhs.index_offset &&
+           lhs.index_type == rhs.index_type && lhs.descriptor_set == rhs.descriptor_set &&
+           lhs.set_index == rhs.set_index &&
+           std::ranges::equal(lhs.dynamic_offsets, rhs.dynamic_offsets) && lhs.topology == rhs.topology &&
+           lhs.instance_count == rhs.instance_count && lhs.first_instance == rhs.first_instance;
+}
+}  // namespace
+
 // --------------------------------------------------------
 // RenderTarget class implementation
 
@@ -23,6 +41,9 @@ RenderTarget::~RenderTarget() {
     destroyFrameResources();
     for (std::uint32_t n = 0; n < std::uint32_t(frame_render_kits_.size()); ++n) {
         auto& kit = frame_render_kits_[n];
+        kit.transient_desc_sets.clear();
+        kit.transient_desc_allocator.destroy();
+        kit.desc_buffer.destroy();
         device_->vkDestroyFence(kit.fence, nullptr);
         device_->getGraphicsQueue().releaseCommandBuffer(n, kit.command_buffer);
     }
@@ -44,6 +65,9 @@ bool RenderTarget::create(const uxs::db::value& opts) {
 
     image_format_ = frame_image_provider_->getImageFormat();
 
+    // Shader objects can be used only with dynamic rendering, which doesn't need a render pass and framebuffers
+    if (device_->useShaderObject()) { return createFrameResources(); }
+
     uxs::inline_dynarray<VkAttachmentDescription, 2> attachments_descriptions;
 
     attachments_descriptions.emplace_back(VkAttachmentDescription{
@@ -201,6 +225,8 @@ bool RenderTarget::createFrameResources() {
             });
         }
 
+        if (device_->useShaderObject()) { continue; }
+
         const VkFramebufferAttachmentsCreateInfo attachments_create_info{
             .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO,
             .attachmentImageInfoCount = std::uint32_t(attachment_infos.size()),
@@ -243,6 +269,42 @@ void RenderTarget::destroyFrameResources() {
     }
 }
 
+DescriptorSet* RenderTarget::obtainTransientDescriptorSet(PipelineLayout& pipeline_layout,
+                                                         std::uint32_t set_layout_index) {
+    auto& kit = frame_render_kits_[n_frame_];
+
+    DescriptorAllocator::Allocation allocation{};
+
+    // Sets stored in descriptor buffers are not allocated from pools
+    if (!device_->useDescriptorBuffer()) {
+        if (!kit.transient_desc_allocator.isCreated()) {
+            kit.transient_desc_allocator.create(*device_, 0, TRANSIENT_DESC_POOL_MAX_SETS, {});
+        }
+
+        if (!kit.transient_desc_allocator.allocate(pipeline_layout.getSetLayout(set_layout_index),
+                                                   pipeline_layout.getSetDescCounts(set_layout_index), allocation)) {
+            return nullptr;
+        }
+    }
+
+    // Descriptor set objects are reused from frame to frame
+    if (kit.transient_desc_set_count == kit.transient_desc_sets.size()) {
+        kit.transient_desc_sets.emplace_back(util::make_new<DescriptorSet>(*device_, pipeline_layout));
+    }
+
+    const PipelineLayout::DescriptorSetHandle handle{
+        .binding_offsets = &pipeline_layout.getBindingOffsets(set_layout_index),
+        .handle = allocation.handle,
+        .set_layout_index = set_layout_index,
+        .pool_index = INVALID_UINT32_VALUE,
+        .pool_generation = 0,
+    };
+
+    auto& descriptor_set = *kit.transient_desc_sets[kit.transient_desc_set_count++];
+    descriptor_set.assignTransient(pipeline_layout, handle);
+    return &descriptor_set;
+}
+
 //@{ IRenderTarget
 
 RenderTargetResult RenderTarget::beginRenderTarget(const Color4f& clear_color, float depth, std::uint32_t stencil,
@@ -257,12 +319,35 @@ RenderTargetResult RenderTarget::beginRenderTarget(const Color4f& clear_color, f
 
     if (!device_->getGraphicsQueue().resetCommandPool(n_frame_)) { return RenderTargetResult::FAILED; }
 
+    device_->beginFrame(getFifCount(), n_device_frame_);
+
+    // The frame is finished, so all its transient descriptor sets are released at once
+    if (kit.transient_desc_set_count != 0) {
+        kit.transient_desc_allocator.reset();
+        for (std::uint32_t n = 0; n < kit.transient_desc_set_count; ++n) {
+            kit.transient_desc_sets[n]->releaseTransient();
+        }
+        kit.transient_desc_set_count = 0;
+    }
+
+    if (device_->useDescriptorBuffer()) {
+        if (!kit.desc_buffer.isCreated() && !kit.desc_buffer.create(*device_, device_->getDescriptorBufferSize())) {
+            return RenderTargetResult::FAILED;
+        }
+        kit.desc_buffer.reset();
+        kit.desc_buffer_offsets.clear();
+    }
+
     current_image_index_ = 0;
     render_target_status_ = frame_image_provider_->acquireFrameImage(ACQUIRE_FRAME_IMAGE_TIMEOUT, current_image_index_);
     if (render_target_status_ > RenderTargetResult::SUBOPTIMAL) { return render_target_status_; }
 
     if (!kit.command_buffer.beginCommandBuffer(0, nullptr)) { return RenderTargetResult::FAILED; }
 
+    if (kit.desc_buffer.isCreated()) {
+        kit.command_buffer.bindDescriptorBuffers(std::array{kit.desc_buffer.getBindingInfo()});
+    }
+
     frame_image_provider_->imageBarrierBefore(kit.command_buffer, current_image_index_);
 
     uxs::inline_dynarray<VkClearValue, 2> clear_values;
@@ -277,20 +362,39 @@ RenderTargetResult RenderTarget::beginRenderTarget(const Color4f& clear_color, f
 
     const VkRect2D view_rect{.offset = {.x = 0, .y = 0}, .extent = image_extent_};
 
-    kit.command_buffer.beginRenderPass(render_pass_, kit.framebuffer, view_rect, VK_SUBPASS_CONTENTS_INLINE,
-                                       clear_values, attachments);
+    if (device_->useShaderObject()) {
+        beginRendering(kit, view_rect, clear_values);
+    } else {
+        kit.command_buffer.beginRenderPass(render_pass_, kit.framebuffer, view_rect, VK_SUBPASS_CONTENTS_INLINE,
+                                           clear_values, attachments);
+    }
 
-    kit.command_buffer.setViewports(0, std::array{VkViewport{.x = 0.f,
-                                                             .y = 0.f,
-                                                             .width = float(image_extent_.width),
-                                                             .height = float(image_extent_.height),
-                                                             .minDepth = 0.f,
-                                                             .maxDepth = 1.f}});
+    const std::array viewports{VkViewport{.x = 0.f,
+                                          .y = 0.f,
+                                          .width = float(image_extent_.width),
+                                          .height = float(image_extent_.height),
+                                          .minDepth = 0.f,
+                                          .maxDepth = 1.f}};
+
+    // Viewport and scissor counts aren't taken from pipeline state, if shader objects are used
+    if (device_->useShaderObject()) {
+        kit.command_buffer.setViewportsWithCount(viewports);
+        kit.command_buffer.setScissorsWithCount(std::array{view_rect});
+    } else {
+        kit.command_buffer.setViewports(0, viewports);
+        kit.command_buffer.setScissors(0, std::array{view_rect});
+    }
 
-    kit.command_buffer.setScissors(0, std::array{view_rect});
+    // Nothing is bound to the command buffer yet
+    current_pipeline_ = nullptr;
+    bound_state_.pipeline_layout = VK_NULL_HANDLE;
+    bound_state_.vertex_buffers.clear();
+    bound_state_.index_buffer = {};
+    bound_state_.descriptor_sets.clear();
+    bind_statistics_ = {};
+    dynamic_state_ = {};
 
-    current_pipeline_ = &static_cast<Pipeline&>(pipeline);
-    kit.command_buffer.vkCmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, current_pipeline_->getHandle());
+    bindPipeline(pipeline);
 
     return render_target_status_;
 }
@@ -298,7 +402,11 @@ RenderTargetResult RenderTarget::beginRenderTarget(const Color4f& clear_color, f
 bool RenderTarget::endRenderTarget() {
     auto& kit = frame_render_kits_[n_frame_];
 
-    kit.command_buffer.vkCmdEndRenderPass();
+    if (device_->useShaderObject()) {
+        endRendering(kit);
+    } else {
+        kit.command_buffer.vkCmdEndRenderPass();
+    }
 
     frame_image_provider_->imageBarrierAfter(kit.command_buffer, current_image_index_);
 
@@ -314,31 +422,65 @@ bool RenderTarget::endRenderTarget() {
 
 void RenderTarget::setViewport(const Rect& rect, float z_near, float z_far) {
     auto& kit = frame_render_kits_[n_frame_];
-    kit.command_buffer.setViewports(0, std::array{VkViewport{
-                                           .x = float(rect.offset.x),
-                                           .y = float(rect.offset.y),
-                                           .width = float(rect.extent.width),
-                                           .height = float(rect.extent.height),
-                                           .minDepth = z_near,
-                                           .maxDepth = z_far,
-                                       }});
+    const std::array viewports{VkViewport{
+        .x = float(rect.offset.x),
+        .y = float(rect.offset.y),
+        .width = float(rect.extent.width),
+        .height = float(rect.extent.height),
+        .minDepth = z_near,
+        .maxDepth = z_far,
+    }};
+    if (device_->useShaderObject()) {
+        kit.command_buffer.setViewportsWithCount(viewports);
+    } else {
+        kit.command_buffer.setViewports(0, viewports);
+    }
 }
 
 void RenderTarget::setScissor(const Rect& rect) {
     auto& kit = frame_render_kits_[n_frame_];
-    kit.command_buffer.setScissors(
-        0, std::array{VkRect2D{.offset = {.x = rect.offset.x, .y = rect.offset.y},
-                               .extent = {.width = rect.extent.width, .height = rect.extent.height}}});
+    const std::array scissors{VkRect2D{.offset = {.x = rect.offset.x, .y = rect.offset.y},
+                                       .extent = {.width = rect.extent.width, .height = rect.extent.height}}};
+    if (device_->useShaderObject()) {
+        kit.command_buffer.setScissorsWithCount(scissors);
+    } else {
+        kit.command_buffer.setScissors(0, scissors);
+    }
 }
 
 void RenderTarget::bindPipeline(IPipeline& pipeline) {
     auto& kit = frame_render_kits_[n_frame_];
+    assert(pipeline.getStatus() == PipelineStatus::READY);
+    if (countBind(current_pipeline_ == &pipeline)) { return; }
     current_pipeline_ = &static_cast<Pipeline&>(pipeline);
-    kit.command_buffer.vkCmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, current_pipeline_->getHandle());
+    current_pipeline_->bind(kit.command_buffer);
+    if (device_->useShaderObject()) { applyDynamicState(dynamic_state_); }
+
+    // Dynamic state, including vertex strides, must be set again after another pipeline is bound
+    bound_state_.topology = VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
+    for (auto& binding : bound_state_.vertex_buffers) {
+        if (binding.stride != 0) { binding.buffer = VK_NULL_HANDLE; }
+    }
+
+    // Sets bound with a different layout are not considered as bound
+    const VkPipelineLayout pipeline_layout = current_pipeline_->getLayout().getHandle();
+    if (pipeline_layout != bound_state_.pipeline_layout) {
+        bound_state_.pipeline_layout = pipeline_layout;
+        bound_state_.descriptor_sets.clear();
+    }
 }
 
 void RenderTarget::bindVertexBuffer(IBuffer& buffer, std::uint32_t slot, std::uint32_t stride, std::uint32_t offset) {
     auto& kit = frame_render_kits_[n_frame_];
+    const VertexBufferBinding binding{
+        .buffer = static_cast<Buffer&>(buffer).getHandle(),
+        .offset = offset,
+        .stride = stride,
+    };
+    if (slot >= bound_state_.vertex_buffers.size()) { bound_state_.vertex_buffers.resize(slot + 1); }
+    if (countBind(bound_state_.vertex_buffers[slot] == binding)) { return; }
+    bound_state_.vertex_buffers[slot] = binding;
+
     if (stride != 0) {
         kit.command_buffer.bindVertexBuffers2(
             slot, {std::array{static_cast<Buffer&>(buffer).getHandle()}, std::array{VkDeviceSize(offset)},
@@ -349,24 +491,198 @@ void RenderTarget::bindVertexBuffer(IBuffer& buffer, std::uint32_t slot, std::ui
     }
 }
 
+void RenderTarget::bindIndexBuffer(IBuffer& buffer, std::uint64_t offset, IndexType index_type) {
+    auto& kit = frame_render_kits_[n_frame_];
+    const IndexBufferBinding binding{
+        .buffer = static_cast<Buffer&>(buffer).getHandle(),
+        .offset = offset,
+        .index_type = TBL_VK_INDEX_TYPE[unsigned(index_type)],
+    };
+    if (countBind(bound_state_.index_buffer == binding)) { return; }
+    bound_state_.index_buffer = binding;
+    kit.command_buffer.vkCmdBindIndexBuffer(binding.buffer, binding.offset, binding.index_type);
+}
+
 void RenderTarget::bindDescriptorSet(IDescriptorSet& descriptor_set, std::uint32_t set_index) {
     auto& kit = frame_render_kits_[n_frame_];
+
+    // Descriptor data is copied to the descriptor buffer of the frame once for each version of set contents
+    if (device_->useDescriptorBuffer()) {
+        const auto& set = static_cast<DescriptorSet&>(descriptor_set);
+        const std::uint64_t version = set.getDescriptorDataVersion();
+        if (isDescriptorSetBound(set_index, VK_NULL_HANDLE, {}, version)) { return; }
+
+        auto [it, is_new] = kit.desc_buffer_offsets.try_emplace(version, 0);
+        if (is_new) {
+            it->second = kit.desc_buffer.append(set.getDescriptorData());
+            if (it->second == VK_WHOLE_SIZE) {
+                kit.desc_buffer_offsets.erase(it);
+                bound_state_.descriptor_sets[set_index] = {};
+                return;
+            }
+        }
+        kit.command_buffer.setDescriptorBufferOffsets(VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                      current_pipeline_->getLayout().getHandle(), set_index,
+                                                      {std::array{0u}, std::array{it->second}});
+        return;
+    }
+
+    const VkDescriptorSet handle = static_cast<DescriptorSet&>(descriptor_set).getHandle();
+    if (isDescriptorSetBound(set_index, handle, {})) { return; }
     kit.command_buffer.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, current_pipeline_->getLayout().getHandle(),
-                                          set_index,
-                                          std::array{static_cast<DescriptorSet&>(descriptor_set).getHandle()}, {});
+                                          set_index, std::array{handle}, {});
 }
 
 void RenderTarget::bindDescriptorSetDynamic(IDescriptorSet& descriptor_set, std::uint32_t set_index,
                                             std::span<const std::uint32_t> offsets) {
+    if (device_->useDescriptorBuffer()) {
+        assert(offsets.empty());  // dynamic descriptors are not allowed in descriptor buffer mode
+        bindDescriptorSet(descriptor_set, set_index);
+        return;
+    }
+
     auto& kit = frame_render_kits_[n_frame_];
+    const VkDescriptorSet handle = static_cast<DescriptorSet&>(descriptor_set).getHandle();
+    if (isDescriptorSetBound(set_index, handle, offsets)) { return; }
     kit.command_buffer.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, current_pipeline_->getLayout().getHandle(),
-                                          set_index,
-                                          std::array{static_cast<DescriptorSet&>(descriptor_set).getHandle()}, offsets);
+                                          set_index, std::array{handle}, offsets);
+}
+
+void RenderTarget::pushConstants(ShaderStage stage, std::uint32_t offset, std::span<const std::uint8_t> data) {
+    auto& kit = frame_render_kits_[n_frame_];
+    auto& pipeline_layout = current_pipeline_->getLayout();
+    const auto size = std::uint32_t(data.size());
+    // Stages of all ranges overlapping the updated range are taken, if a particular stage isn't specified
+    const auto stage_flags = stage == ShaderStage::ALL_STAGES ?
+                                 pipeline_layout.getPushConstantStages(offset, size) :
+                                 VkShaderStageFlags(TBL_VK_SHADER_STAGE[unsigned(stage)]);
+    if (!pipeline_layout.isPushConstantUpdateValid(stage_flags, offset, size)) {
+        logError(LOG_VK "push constants can't be updated: stages don't match push constant ranges");
+        return;
+    }
+    kit.command_buffer.pushConstants(pipeline_layout.getHandle(), stage_flags, offset, data);
+}
+
+void RenderTarget::pushDescriptors(std::uint32_t set_index, std::span<const DescriptorData> descriptors) {
+    auto& kit = frame_render_kits_[n_frame_];
+    auto& pipeline_layout = current_pipeline_->getLayout();
+    if (set_index >= pipeline_layout.getSetLayouts().size() || !pipeline_layout.getUpdateTemplate(set_index).is_push) {
+        logError(LOG_VK "descriptors can't be pushed: set {} isn't a push descriptor set", set_index);
+        return;
+    }
+    const auto& update_template = pipeline_layout.getUpdateTemplate(set_index);
+    if (descriptors.size() != update_template.desc_types.size()) {
+        logError(LOG_VK "descriptors can't be pushed: {} descriptors are expected, {} are given",
+                 update_template.desc_types.size(), descriptors.size());
+        return;
+    }
+    if (update_template.has_texel_buffers) {
+        logError(LOG_VK "descriptors can't be pushed: layout has texel buffers");
+        return;
+    }
+
+    uxs::inline_dynarray<PipelineLayout::DescriptorInfo, 32> desc_infos(descriptors.size());
+    PipelineLayout::makeDescriptorInfos(update_template, descriptors, desc_infos);
+
+    uxs::inline_dynarray<VkWriteDescriptorSet, 8> write_descriptors;
+    for (const auto& entry : update_template.entries) {
+        const auto* desc_info = &desc_infos[entry.offset / sizeof(PipelineLayout::DescriptorInfo)];
+        const bool is_buffer = entry.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                               entry.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+                               entry.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                               entry.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        write_descriptors.emplace_back(VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstBinding = entry.dstBinding,
+            .dstArrayElement = entry.dstArrayElement,
+            .descriptorCount = entry.descriptorCount,
+            .descriptorType = entry.descriptorType,
+            .pImageInfo = is_buffer ? nullptr : &desc_info->image,
+            .pBufferInfo = is_buffer ? &desc_info->buffer : nullptr,
+        });
+    }
+
+    kit.command_buffer.pushDescriptorSet(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout.getHandle(), set_index,
+                                         write_descriptors);
+
+    // Pushed descriptors replace the set bound to this index
+    if (set_index < bound_state_.descriptor_sets.size()) {
+        bound_state_.descriptor_sets[set_index] = {};
+    }
+}
+
+void RenderTarget::bindBindlessDescriptorSet() {
+    auto& kit = frame_render_kits_[n_frame_];
+    auto& pipeline_layout = current_pipeline_->getLayout();
+    assert(pipeline_layout.getBindlessSetIndex() != INVALID_UINT32_VALUE);
+    const VkDescriptorSet handle = device_->getBindlessHeap().getDescriptorSet();
+    if (isDescriptorSetBound(pipeline_layout.getBindlessSetIndex(), handle, {})) { return; }
+    kit.command_buffer.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout.getHandle(),
+                                          pipeline_layout.getBindlessSetIndex(), std::array{handle}, {});
 }
 
 void RenderTarget::setPrimitiveTopology(PrimitiveTopology topology) {
     auto& kit = frame_render_kits_[n_frame_];
-    kit.command_buffer.vkCmdSetPrimitiveTopologyEXT(TBL_VK_PRIMITIVE_TOPOLOGY[unsigned(topology)]);
+    const VkPrimitiveTopology vk_topology = TBL_VK_PRIMITIVE_TOPOLOGY[unsigned(topology)];
+    if (countBind(bound_state_.topology == vk_topology)) { return; }
+    bound_state_.topology = vk_topology;
+    kit.command_buffer.vkCmdSetPrimitiveTopologyEXT(vk_topology);
+}
+
+void RenderTarget::setCullMode(CullMode cull_mode) {
+    if (!checkDynamicState(DynamicStateType::CULL_MODE)) { return; }
+    dynamic_state_.cull_mode = TBL_VK_CULL_MODE[unsigned(cull_mode)];
+    applyDynamicState({.cull_mode = dynamic_state_.cull_mode});
+}
+
+void RenderTarget::setFrontFace(FrontFace front_face) {
+    if (!checkDynamicState(DynamicStateType::FRONT_FACE)) { return; }
+    dynamic_state_.front_face = TBL_VK_FRONT_FACE[unsigned(front_face)];
+    applyDynamicState({.front_face = dynamic_state_.front_face});
+}
+
+void RenderTarget::setDepthTest(bool enable, bool write_enable, CompareOp compare_op) {
+    if (!checkDynamicState(DynamicStateType::DEPTH_TEST)) { return; }
+    dynamic_state_.depth_test = DepthTestState{
+        .enable = enable ? VK_TRUE : VK_FALSE,
+        .write_enable = write_enable ? VK_TRUE : VK_FALSE,
+        .compare_op = TBL_VK_COMPARE_OP[unsigned(compare_op)],
+    };
+    applyDynamicState({.depth_test = dynamic_state_.depth_test});
+}
+
+void RenderTarget::setDepthBias(bool enable, float constant_factor, float clamp, float slope_factor) {
+    if (!checkDynamicState(DynamicStateType::DEPTH_BIAS)) { return; }
+    dynamic_state_.depth_bias = DepthBiasState{
+        .enable = enable ? VK_TRUE : VK_FALSE,
+        .constant_factor = constant_factor,
+        .clamp = clamp,
+        .slope_factor = slope_factor,
+    };
+    applyDynamicState({.depth_bias = dynamic_state_.depth_bias});
+}
+
+void RenderTarget::setPolygonMode(PolygonMode polygon_mode) {
+    if (!checkDynamicState(DynamicStateType::POLYGON_MODE)) { return; }
+    dynamic_state_.polygon_mode = TBL_VK_POLYGON_MODE[unsigned(polygon_mode)];
+    applyDynamicState({.polygon_mode = dynamic_state_.polygon_mode});
+}
+
+void RenderTarget::setBlendState(bool enable, const BlendEquation& equation) {
+    if (!checkDynamicState(DynamicStateType::BLEND_STATE)) { return; }
+    dynamic_state_.blend = BlendState{
+        .enable = enable ? VK_TRUE : VK_FALSE,
+        .equation =
+            {
+                .srcColorBlendFactor = TBL_VK_BLEND_FACTOR[unsigned(equation.src_color_factor)],
+                .dstColorBlendFactor = TBL_VK_BLEND_FACTOR[unsigned(equation.dest_color_factor)],
+                .colorBlendOp = TBL_VK_BLEND_OP[unsigned(equation.color_op)],
+                .srcAlphaBlendFactor = TBL_VK_BLEND_FACTOR[unsigned(equation.src_alpha_factor)],
+                .dstAlphaBlendFactor = TBL_VK_BLEND_FACTOR[unsigned(equation.dest_alpha_factor)],
+                .alphaBlendOp = TBL_VK_BLEND_OP[unsigned(equation.alpha_op)],
+            },
+    };
+    applyDynamicState({.blend = dynamic_state_.blend});
 }
 
 void RenderTarget::drawGeometry(std::uint32_t vertex_count, std::uint32_t instance_count, std::uint32_t first_vertex,
@@ -375,4 +691,283 @@ void RenderTarget::drawGeometry(std::uint32_t vertex_count, std::uint32_t instan
     kit.command_buffer.vkCmdDraw(vertex_count, instance_count, first_vertex, first_instance);
 }
 
+void RenderTarget::drawIndexedGeometry(std::uint32_t index_count, std::uint32_t instance_count,
+                                       std::uint32_t first_index, std::int32_t vertex_offset,
+                                       std::uint32_t first_instance) {
+    auto& kit = frame_render_kits_[n_frame_];
+    kit.command_buffer.vkCmdDrawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
+}
+
+void RenderTarget::drawIndirect(IBuffer& buffer, std::uint64_t offset, std::uint32_t draw_count, std::uint32_t stride) {
+    auto& kit = frame_render_kits_[n_frame_];
+    const VkBuffer handle = static_cast<Buffer&>(buffer).getHandle();
+    if (stride == 0) { stride = sizeof(DrawIndirectArgs); }
+
+    const std::uint32_t max_draw_count = getMaxIndirectDrawCount();
+    while (draw_count > 0) {
+        const std::uint32_t count = std::min(draw_count, max_draw_count);
+        kit.command_buffer.vkCmdDrawIndirect(handle, offset, count, stride);
+        offset += std::uint64_t(count) * stride;
+        draw_count -= count;
+    }
+}
+
+void RenderTarget::drawIndexedIndirect(IBuffer& buffer, std::uint64_t offset, std::uint32_t draw_count,
+                                       std::uint32_t stride) {
+    auto& kit = frame_render_kits_[n_frame_];
+    const VkBuffer handle = static_cast<Buffer&>(buffer).getHandle();
+    if (stride == 0) { stride = sizeof(DrawIndexedIndirectArgs); }
+
+    const std::uint32_t max_draw_count = getMaxIndirectDrawCount();
+    while (draw_count > 0) {
+        const std::uint32_t count = std::min(draw_count, max_draw_count);
+        kit.command_buffer.vkCmdDrawIndexedIndirect(handle, offset, count, stride);
+        offset += std::uint64_t(count) * stride;
+        draw_count -= count;
+    }
+}
+
+void RenderTarget::drawIndirectCount(IBuffer& buffer, std::uint64_t offset, IBuffer& count_buffer,
+                                     std::uint64_t count_offset, std::uint32_t max_draw_count, std::uint32_t stride) {
+    auto& kit = frame_render_kits_[n_frame_];
+    if (!checkIndirectDrawCount(max_draw_count)) { return; }
+    if (stride == 0) { stride = sizeof(DrawIndirectArgs); }
+    kit.command_buffer.vkCmdDrawIndirectCountKHR(static_cast<Buffer&>(buffer).getHandle(), offset,
+                                                 static_cast<Buffer&>(count_buffer).getHandle(), count_offset,
+                                                 max_draw_count, stride);
+}
+
+void RenderTarget::drawIndexedIndirectCount(IBuffer& buffer, std::uint64_t offset, IBuffer& count_buffer,
+                                            std::uint64_t count_offset, std::uint32_t max_draw_count,
+                                            std::uint32_t stride) {
+    auto& kit = frame_render_kits_[n_frame_];
+    if (!checkIndirectDrawCount(max_draw_count)) { return; }
+    if (stride == 0) { stride = sizeof(DrawIndexedIndirectArgs); }
+    kit.command_buffer.vkCmdDrawIndexedIndirectCountKHR(static_cast<Buffer&>(buffer).getHandle(), offset,
+                                                        static_cast<Buffer&>(count_buffer).getHandle(), count_offset,
+                                                        max_draw_count, stride);
+}
+
+void RenderTarget::submitDrawPackets(std::span<const DrawPacket> packets) {
+    auto& kit = frame_render_kits_[n_frame_];
+    const std::size_t max_batch_size =
+        device_->useMultiDraw() ? device_->getPhysicalDevice().getMultiDrawProperties().maxMultiDrawCount : 1;
+
+    uxs::inline_dynarray<VkMultiDrawInfoEXT, 64> draw_infos;
+    uxs::inline_dynarray<VkMultiDrawIndexedInfoEXT, 64> indexed_draw_infos;
+    for (std::size_t n = 0; n < packets.size();) {
+        const auto& packet = packets[n];
+        bindDrawPacketState(packet);
+
+        std::size_t batch_size = 1;
+        while (batch_size < max_batch_size && n + batch_size < packets.size() &&
+               isSameDrawState(packets[n + batch_size], packet)) {
+            ++batch_size;
+        }
+
+        if (packet.index_buffer && batch_size == 1) {
+            kit.command_buffer.vkCmdDrawIndexed(packet.index_count, packet.instance_count, packet.first_index,
+                                                packet.base_vertex, packet.first_instance);
+        } else if (packet.index_buffer) {
+            indexed_draw_infos.clear();
+            for (const auto& batch_packet : packets.subspan(n, batch_size)) {
+                indexed_draw_infos.push_back(VkMultiDrawIndexedInfoEXT{
+                    .firstIndex = batch_packet.first_index,
+                    .indexCount = batch_packet.index_count,
+                    .vertexOffset = batch_packet.base_vertex,
+                });
+            }
+            // Null vertex offset pointer means that offsets are taken from draw infos
+            kit.command_buffer.vkCmdDrawMultiIndexedEXT(std::uint32_t(indexed_draw_infos.size()),
+                                                        indexed_draw_infos.data(), packet.instance_count,
+                                                        packet.first_instance, sizeof(VkMultiDrawIndexedInfoEXT),
+                                                        nullptr);
+        } else if (batch_size == 1) {
+            kit.command_buffer.vkCmdDraw(packet.vertex_count, packet.instance_count, packet.first_vertex,
+                                         packet.first_instance);
+        } else {
+            draw_infos.clear();
+            for (const auto& batch_packet : packets.subspan(n, batch_size)) {
+                draw_infos.push_back(VkMultiDrawInfoEXT{
+                    .firstVertex = batch_packet.first_vertex,
+                    .vertexCount = batch_packet.vertex_count,
+                });
+            }
+            kit.command_buffer.vkCmdDrawMultiEXT(std::uint32_t(draw_infos.size()), draw_infos.data(),
+                                                 packet.instance_count, packet.first_instance,
+                                                 sizeof(VkMultiDrawInfoEXT));
+        }
+
+        n += batch_size;
+    }
+}
+
 //@}
+
+void RenderTarget::beginRendering(FrameRenderKit& kit, VkRect2D render_area,
+                                  std::span<const VkClearValue> clear_values) {
+    // Layout transitions of render pass attachments are made by barriers
+    uxs::inline_dynarray<VkImageMemoryBarrier, 2> barriers;
+
+    barriers.emplace_back(Wrapper<VkImageMemoryBarrier>::unwrap({
+        .image = frame_image_provider_->getImage(current_image_index_),
+        .current_access = VK_ACCESS_NONE,
+        .new_access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        .current_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .new_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .current_queue_family = VK_QUEUE_FAMILY_IGNORED,
+        .new_queue_family = VK_QUEUE_FAMILY_IGNORED,
+        .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+    }));
+
+    if (use_depth_) {
+        barriers.emplace_back(Wrapper<VkImageMemoryBarrier>::unwrap({
+            .image = kit.depth_stencil_image,
+            .current_access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .new_access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .current_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .new_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .current_queue_family = VK_QUEUE_FAMILY_IGNORED,
+            .new_queue_family = VK_QUEUE_FAMILY_IGNORED,
+            .aspect = VK_IMAGE_ASPECT_DEPTH_BIT,
+        }));
+    }
+
+    kit.command_buffer.setImageMemoryBarrier(
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        barriers);
+
+    const std::array color_attachments{VkRenderingAttachmentInfoKHR{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+        .imageView = frame_image_provider_->getImageView(current_image_index_),
+        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .clearValue = clear_values[0],
+    }};
+
+    VkRenderingAttachmentInfoKHR depth_stencil_attachment{};
+    if (use_depth_) {
+        depth_stencil_attachment = VkRenderingAttachmentInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+            .imageView = kit.depth_stencil_image_view,
+            .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .clearValue = clear_values[1],
+        };
+    }
+
+    kit.command_buffer.beginRendering(render_area, color_attachments,
+                                      use_depth_ ? &depth_stencil_attachment : nullptr);
+}
+
+void RenderTarget::endRendering(FrameRenderKit& kit) {
+    kit.command_buffer.vkCmdEndRenderingKHR();
+
+    // The same dependency as the external one of the render pass
+    kit.command_buffer.setImageMemoryBarrier(
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, frame_image_provider_->getImageConsumingStages(),
+        std::array{
+            Wrapper<VkImageMemoryBarrier>::unwrap({
+                .image = frame_image_provider_->getImage(current_image_index_),
+                .current_access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                .new_access = frame_image_provider_->getImageAccess(),
+                .current_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                .new_layout = frame_image_provider_->getImageLayout(),
+                .current_queue_family = VK_QUEUE_FAMILY_IGNORED,
+                .new_queue_family = VK_QUEUE_FAMILY_IGNORED,
+                .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+            }),
+        });
+}
+
+bool RenderTarget::checkDynamicState(DynamicStateType type) {
+    static constexpr std::array state_names{
+        "cull mode", "front face", "depth test", "depth bias", "polygon mode", "blend state",
+    };
+    const char* state_name = state_names[unsigned(type)];
+    if (!device_->isDynamicStateSupported(type)) {
+        logError(LOG_VK "dynamic {} is not supported", state_name);
+        return false;
+    }
+    if (current_pipeline_ && !current_pipeline_->isDynamicState(type)) {
+        logWarning(LOG_VK "{} is not dynamic in the bound pipeline and is overridden by its fixed state", state_name);
+    }
+    return true;
+}
+
+std::uint32_t RenderTarget::getMaxIndirectDrawCount() const {
+    // Several draws from one command need the `multiDrawIndirect` feature
+    if (!device_->getPhysicalDevice().getFeatures().multiDrawIndirect) { return 1; }
+    return std::max(device_->getPhysicalDevice().getProperties().limits.maxDrawIndirectCount, 1u);
+}
+
+bool RenderTarget::checkIndirectDrawCount(std::uint32_t max_draw_count) const {
+    if (!device_->isExtensionEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) {
+        logError(LOG_VK "indirect draw count is not supported");
+        return false;
+    }
+    // Draws with the count read by the device can't be split
+    if (max_draw_count > getMaxIndirectDrawCount()) {
+        logError(LOG_VK "maximum indirect draw count {} exceeds device limit {}", max_draw_count,
+                 getMaxIndirectDrawCount());
+        return false;
+    }
+    return true;
+}
+
+void RenderTarget::applyDynamicState(const DynamicState& state) {
+    auto& kit = frame_render_kits_[n_frame_];
+    if (state.cull_mode) { kit.command_buffer.vkCmdSetCullModeEXT(*state.cull_mode); }
+    if (state.front_face) { kit.command_buffer.vkCmdSetFrontFaceEXT(*state.front_face); }
+    if (state.depth_test) {
+        kit.command_buffer.vkCmdSetDepthTestEnableEXT(state.depth_test->enable);
+        kit.command_buffer.vkCmdSetDepthWriteEnableEXT(state.depth_test->write_enable);
+        kit.command_buffer.vkCmdSetDepthCompareOpEXT(state.depth_test->compare_op);
+    }
+    if (state.depth_bias) {
+        kit.command_buffer.vkCmdSetDepthBiasEnableEXT(state.depth_bias->enable);
+        kit.command_buffer.vkCmdSetDepthBias(state.depth_bias->constant_factor, state.depth_bias->clamp,
+                                             state.depth_bias->slope_factor);
+    }
+    if (state.polygon_mode) { kit.command_buffer.vkCmdSetPolygonModeEXT(*state.polygon_mode); }
+    if (state.blend) {
+        kit.command_buffer.vkCmdSetColorBlendEnableEXT(0, 1, &state.blend->enable);
+        kit.command_buffer.vkCmdSetColorBlendEquationEXT(0, 1, &state.blend->equation);
+    }
+}
+
+void RenderTarget::bindDrawPacketState(const DrawPacket& packet) {
+    if (packet.pipeline) { bindPipeline(*packet.pipeline); }
+    if (packet.vertex_buffer) {
+        bindVertexBuffer(*packet.vertex_buffer, 0, packet.vertex_stride, packet.vertex_offset);
+    }
+    if (packet.index_buffer) { bindIndexBuffer(*packet.index_buffer, packet.index_offset, packet.index_type); }
+    if (packet.descriptor_set) {
+        bindDescriptorSetDynamic(*packet.descriptor_set, packet.set_index, packet.dynamic_offsets);
+    }
+    if (packet.topology) { setPrimitiveTopology(*packet.topology); }
+}
+
+bool RenderTarget::countBind(bool is_redundant) {
+    ++(is_redundant ? bind_statistics_.skipped_count : bind_statistics_.emitted_count);
+    return is_redundant;
+}
+
+bool RenderTarget::isDescriptorSetBound(std::uint32_t set_index, VkDescriptorSet handle,
+                                        std::span<const std::uint32_t> offsets, std::uint64_t desc_data_version) {
+    auto& descriptor_sets = bound_state_.descriptor_sets;
+    if (set_index >= descriptor_sets.size()) { descriptor_sets.resize(set_index + 1); }
+    auto& binding = descriptor_sets[set_index];
+    if (countBind(binding.handle == handle && std::ranges::equal(binding.offsets, offsets) &&
+                  binding.desc_data_version == desc_data_version)) {
+        return true;
+    }
+    binding.handle = handle;
+    binding.offsets.assign(offsets.begin(), offsets.end());
+    binding.desc_data_version = desc_data_version;
+    return false;
+}
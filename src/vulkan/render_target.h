@@ -1,16 +1,24 @@
 #pragma once
 
 #include "command_buffer.h"
+#include "descriptor_allocator.h"
+#include "descriptor_buffer.h"
 
 #include "common/core_defs.h"
 
 #include <uxs/dynarray.h>
 
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 namespace app3d::rel::vulkan {
 
 class Device;
 class FrameImageProvider;
 class Pipeline;
+class PipelineLayout;
+class DescriptorSet;
 
 class RenderTarget final : public util::ref_counter, public IRenderTarget {
  public:
@@ -25,6 +33,8 @@ class RenderTarget final : public util::ref_counter, public IRenderTarget {
 
     VkRenderPass getRenderPass() { return render_pass_; }
 
+    DescriptorSet* obtainTransientDescriptorSet(PipelineLayout& pipeline_layout, std::uint32_t set_layout_index);
+
     //@{ IRenderTarget
     util::ref_counter& getRefCounter() override { return *this; }
     Extent2u getImageExtent() const override { return {.width = image_extent_.width, .height = image_extent_.height}; }
@@ -37,12 +47,34 @@ class RenderTarget final : public util::ref_counter, public IRenderTarget {
     void setScissor(const Rect& rect) override;
     void bindPipeline(IPipeline& pipeline) override;
     void bindVertexBuffer(IBuffer& buffer, std::uint32_t slot, std::uint32_t stride, std::uint32_t offset) override;
+    void bindIndexBuffer(IBuffer& buffer, std::uint64_t offset, IndexType index_type) override;
     void bindDescriptorSet(IDescriptorSet& descriptor_set, std::uint32_t set_index) override;
     void bindDescriptorSetDynamic(IDescriptorSet& descriptor_set, std::uint32_t set_index,
                                   std::span<const std::uint32_t> offsets) override;
+    void pushConstants(ShaderStage stage, std::uint32_t offset, std::span<const std::uint8_t> data) override;
+    void pushDescriptors(std::uint32_t set_index, std::span<const DescriptorData> descriptors) override;
+    void bindBindlessDescriptorSet() override;
     void setPrimitiveTopology(PrimitiveTopology topology) override;
+    void setCullMode(CullMode cull_mode) override;
+    void setFrontFace(FrontFace front_face) override;
+    void setDepthTest(bool enable, bool write_enable, CompareOp compare_op) override;
+    void setDepthBias(bool enable, float constant_factor, float clamp, float slope_factor) override;
+    void setPolygonMode(PolygonMode polygon_mode) override;
+    void setBlendState(bool enable, const BlendEquation& equation) override;
     void drawGeometry(std::uint32_t vertex_count, std::uint32_t instance_count, std::uint32_t first_vertex,
                       std::uint32_t first_instance) override;
+    void drawIndexedGeometry(std::uint32_t index_count, std::uint32_t instance_count, std::uint32_t first_index,
+                             std::int32_t vertex_offset, std::uint32_t first_instance) override;
+    void drawIndirect(IBuffer& buffer, std::uint64_t offset, std::uint32_t draw_count, std::uint32_t stride) override;
+    void drawIndexedIndirect(IBuffer& buffer, std::uint64_t offset, std::uint32_t draw_count,
+                             std::uint32_t stride) override;
+    void drawIndirectCount(IBuffer& buffer, std::uint64_t offset, IBuffer& count_buffer, std::uint64_t count_offset,
+                           std::uint32_t max_draw_count, std::uint32_t stride) override;
+    void drawIndexedIndirectCount(IBuffer& buffer, std::uint64_t offset, IBuffer& count_buffer,
+                                  std::uint64_t count_offset, std::uint32_t max_draw_count,
+                                  std::uint32_t stride) override;
+    void submitDrawPackets(std::span<const DrawPacket> packets) override;
+    BindStatistics getBindStatistics() const override { return bind_statistics_; }
     //@}
 
  private:
@@ -56,6 +88,69 @@ class RenderTarget final : public util::ref_counter, public IRenderTarget {
     RenderTargetResult render_target_status_{RenderTargetResult::SUCCESS};
     Pipeline* current_pipeline_ = nullptr;
 
+    struct VertexBufferBinding {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset = 0;
+        VkDeviceSize stride = 0;
+        bool operator==(const VertexBufferBinding&) const = default;
+    };
+
+    struct IndexBufferBinding {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset = 0;
+        VkIndexType index_type{VK_INDEX_TYPE_MAX_ENUM};
+        bool operator==(const IndexBufferBinding&) const = default;
+    };
+
+    struct DescriptorSetBinding {
+        VkDescriptorSet handle{VK_NULL_HANDLE};
+        uxs::inline_dynarray<std::uint32_t, 4> offsets;
+        std::uint64_t desc_data_version = 0;  // in descriptor buffer mode
+    };
+
+    // State bound to the command buffer of current frame besides the pipeline, it's used to skip redundant commands
+    struct BoundState {
+        VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
+        VkPrimitiveTopology topology{VK_PRIMITIVE_TOPOLOGY_MAX_ENUM};
+        uxs::inline_dynarray<VertexBufferBinding, 4> vertex_buffers;
+        IndexBufferBinding index_buffer;
+        uxs::inline_dynarray<DescriptorSetBinding, 4> descriptor_sets;
+    };
+
+    BoundState bound_state_;
+
+    struct DepthTestState {
+        VkBool32 enable;
+        VkBool32 write_enable;
+        VkCompareOp compare_op;
+    };
+
+    struct DepthBiasState {
+        VkBool32 enable;
+        float constant_factor;
+        float clamp;
+        float slope_factor;
+    };
+
+    struct BlendState {
+        VkBool32 enable;
+        VkColorBlendEquationEXT equation;
+    };
+
+    // Dynamic state set by the user during current frame: binding of shader objects resets it to defaults, so it's
+    // applied again after each bind
+    struct DynamicState {
+        std::optional<VkCullModeFlags> cull_mode;
+        std::optional<VkFrontFace> front_face;
+        std::optional<DepthTestState> depth_test;
+        std::optional<DepthBiasState> depth_bias;
+        std::optional<VkPolygonMode> polygon_mode;
+        std::optional<BlendState> blend;
+    };
+
+    DynamicState dynamic_state_;
+    BindStatistics bind_statistics_{};
+
     struct FrameRenderKit {
         VkFence fence{VK_NULL_HANDLE};
         VkImage depth_stencil_image{VK_NULL_HANDLE};
@@ -63,14 +158,31 @@ class RenderTarget final : public util::ref_counter, public IRenderTarget {
         VkImageView depth_stencil_image_view{VK_NULL_HANDLE};
         VkFramebuffer framebuffer{VK_NULL_HANDLE};
         CommandBuffer command_buffer;
+        DescriptorAllocator transient_desc_allocator;
+        std::vector<util::ref_ptr<DescriptorSet>> transient_desc_sets;
+        std::uint32_t transient_desc_set_count = 0;
+        DescriptorBuffer desc_buffer;
+        std::unordered_map<std::uint64_t, VkDeviceSize> desc_buffer_offsets;  // by descriptor data version
     };
 
     static constexpr std::uint64_t FINISH_FRAME_TIMEOUT = 5'000'000'000;
     static constexpr std::uint64_t ACQUIRE_FRAME_IMAGE_TIMEOUT = 2'000'000'000;
 
     std::uint32_t n_frame_ = 0;
+    std::uint64_t n_device_frame_ = 0;  // device frame of the last `beginRenderTarget` call
     std::uint32_t current_image_index_ = INVALID_UINT32_VALUE;
     uxs::inline_dynarray<FrameRenderKit, 3> frame_render_kits_;
+
+    void beginRendering(FrameRenderKit& kit, VkRect2D render_area, std::span<const VkClearValue> clear_values);
+    void endRendering(FrameRenderKit& kit);
+    bool checkDynamicState(DynamicStateType type);
+    std::uint32_t getMaxIndirectDrawCount() const;
+    bool checkIndirectDrawCount(std::uint32_t max_draw_count) const;
+    void applyDynamicState(const DynamicState& state);
+    void bindDrawPacketState(const DrawPacket& packet);
+    bool countBind(bool is_redundant);
+    bool isDescriptorSetBound(std::uint32_t set_index, VkDescriptorSet handle, std::span<const std::uint32_t> offsets,
+                              std::uint64_t desc_data_version = 0);
 };
 
 }  // namespace app3d::rel::vulkan
@@ -35,11 +35,7 @@ bool RenderingDriver::init(const uxs::db::value& app_info) {
     if (!createInstance(app_info)) { return false; }
     if (!loadPhysicalDeviceList()) { return false; }
 
-    uxs::db::value platform_args;
-    platform_args["args"] = uxs::db::value(
-        uxs::db::array_tag, {"-spirv", "-O3", "-Dbinding(n)=[[vk::binding(n)]]", "-Dlocation(n)=[[vk::location(n)]]"});
-
-    hlsl_compiler_.setPlatformArgs(platform_args);
+    hlsl_compiler_.setPlatformArgs(HlslCompiler::getSpirvPlatformArgs());
 
     surfaces_.reserve(4);
     return true;
@@ -265,9 +261,42 @@ std::uint32_t PhysicalDevice::findSuitableQueueFamily(VkQueueFlags flags, std::u
 
 bool PhysicalDevice::isSuitableDevice(const uxs::db::value& caps) const {
     if (!features_.geometryShader) { return false; }
+    if (caps.value<bool>("bindless") && !isBindlessSupported()) { return false; }
+    if (caps.value<bool>("descriptor_buffer") && !isDescriptorBufferSupported()) { return false; }
+    if (caps.value<bool>("shader_object") && !isShaderObjectSupported()) { return false; }
     return true;
 }
 
+bool PhysicalDevice::isBindlessSupported() const {
+    const auto& features = descriptor_indexing_features_;
+    return features.runtimeDescriptorArray && features.descriptorBindingPartiallyBound &&
+           features.descriptorBindingSampledImageUpdateAfterBind &&
+           features.descriptorBindingStorageBufferUpdateAfterBind &&
+           features.descriptorBindingUpdateUnusedWhilePending && features.shaderSampledImageArrayNonUniformIndexing &&
+           features.shaderStorageBufferArrayNonUniformIndexing;
+}
+
+bool PhysicalDevice::isDescriptorBufferSupported() const {
+    return isExtensionSupported(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+           descriptor_buffer_features_.descriptorBuffer && buffer_device_address_features_.bufferDeviceAddress;
+}
+
+bool PhysicalDevice::isGraphicsPipelineLibrarySupported() const {
+    return isExtensionSupported(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+           isExtensionSupported(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+           graphics_pipeline_library_features_.graphicsPipelineLibrary;
+}
+
+bool PhysicalDevice::isShaderObjectSupported() const {
+    return isExtensionSupported(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) &&
+           isExtensionSupported(VK_EXT_SHADER_OBJECT_EXTENSION_NAME) && dynamic_rendering_features_.dynamicRendering &&
+           shader_object_features_.shaderObject;
+}
+
+bool PhysicalDevice::isMultiDrawSupported() const {
+    return isExtensionSupported(VK_EXT_MULTI_DRAW_EXTENSION_NAME) && multi_draw_features_.multiDraw;
+}
+
 bool PhysicalDevice::loadExtensionProperties() {
     std::uint32_t extension_count = 0;
     VkResult result = vkEnumerateDeviceExtensionProperties(nullptr, &extension_count, nullptr);
@@ -291,6 +320,59 @@ bool PhysicalDevice::loadFeaturesAndProperties() {
     vkGetPhysicalDeviceFeatures(&features_);
     vkGetPhysicalDeviceMemoryProperties(&memory_properties_);
 
+    // Structures of extensions can be chained only if the extension is supported
+    void* properties_chain = &descriptor_indexing_properties_;
+    void* features_chain = &descriptor_indexing_features_;
+    const auto chain_struct = [](void*& chain, auto& structure) {
+        structure.pNext = chain;
+        chain = &structure;
+    };
+
+    chain_struct(features_chain, buffer_device_address_features_);
+    if (isExtensionSupported(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+        chain_struct(properties_chain, descriptor_buffer_properties_);
+        chain_struct(features_chain, descriptor_buffer_features_);
+    }
+    if (isExtensionSupported(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        chain_struct(properties_chain, graphics_pipeline_library_properties_);
+        chain_struct(features_chain, graphics_pipeline_library_features_);
+    }
+    if (isExtensionSupported(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+        chain_struct(features_chain, dynamic_rendering_features_);
+    }
+    if (isExtensionSupported(VK_EXT_SHADER_OBJECT_EXTENSION_NAME)) {
+        chain_struct(features_chain, shader_object_features_);
+    }
+    if (isExtensionSupported(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+        chain_struct(features_chain, extended_dynamic_state2_features_);
+    }
+    if (isExtensionSupported(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+        chain_struct(features_chain, extended_dynamic_state3_features_);
+    }
+    if (isExtensionSupported(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME)) {
+        chain_struct(properties_chain, vertex_attribute_divisor_properties_);
+        chain_struct(features_chain, vertex_attribute_divisor_features_);
+    }
+    if (isExtensionSupported(VK_EXT_MULTI_DRAW_EXTENSION_NAME)) {
+        chain_struct(properties_chain, multi_draw_properties_);
+        chain_struct(features_chain, multi_draw_features_);
+    }
+    if (isExtensionSupported(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+        chain_struct(properties_chain, push_descriptor_properties_);
+    }
+
+    VkPhysicalDeviceProperties2 properties2{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = properties_chain,
+    };
+    vkGetPhysicalDeviceProperties2(&properties2);
+
+    VkPhysicalDeviceFeatures2 features2{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = features_chain,
+    };
+    vkGetPhysicalDeviceFeatures2(&features2);
+
     std::uint32_t queue_family_count = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(&queue_family_count, nullptr);
     if (queue_family_count == 0) {
@@ -74,10 +74,54 @@ class PhysicalDevice {
     bool isExtensionSupported(const char* extension) const;
     const VkPhysicalDeviceProperties& getProperties() const { return properties_; }
     const VkPhysicalDeviceFeatures& getFeatures() const { return features_; }
+    const VkPhysicalDeviceDescriptorIndexingFeatures& getDescriptorIndexingFeatures() const {
+        return descriptor_indexing_features_;
+    }
+    const VkPhysicalDeviceDescriptorIndexingProperties& getDescriptorIndexingProperties() const {
+        return descriptor_indexing_properties_;
+    }
+    const VkPhysicalDeviceDescriptorBufferFeaturesEXT& getDescriptorBufferFeatures() const {
+        return descriptor_buffer_features_;
+    }
+    const VkPhysicalDeviceDescriptorBufferPropertiesEXT& getDescriptorBufferProperties() const {
+        return descriptor_buffer_properties_;
+    }
+    const VkPhysicalDeviceBufferDeviceAddressFeatures& getBufferDeviceAddressFeatures() const {
+        return buffer_device_address_features_;
+    }
+    const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT& getGraphicsPipelineLibraryFeatures() const {
+        return graphics_pipeline_library_features_;
+    }
+    const VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT& getGraphicsPipelineLibraryProperties() const {
+        return graphics_pipeline_library_properties_;
+    }
+    const VkPhysicalDeviceShaderObjectFeaturesEXT& getShaderObjectFeatures() const { return shader_object_features_; }
+    const VkPhysicalDeviceExtendedDynamicState2FeaturesEXT& getExtendedDynamicState2Features() const {
+        return extended_dynamic_state2_features_;
+    }
+    const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& getExtendedDynamicState3Features() const {
+        return extended_dynamic_state3_features_;
+    }
+    const VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT& getVertexAttributeDivisorFeatures() const {
+        return vertex_attribute_divisor_features_;
+    }
+    const VkPhysicalDeviceVertexAttributeDivisorPropertiesEXT& getVertexAttributeDivisorProperties() const {
+        return vertex_attribute_divisor_properties_;
+    }
+    const VkPhysicalDeviceMultiDrawFeaturesEXT& getMultiDrawFeatures() const { return multi_draw_features_; }
+    const VkPhysicalDeviceMultiDrawPropertiesEXT& getMultiDrawProperties() const { return multi_draw_properties_; }
+    const VkPhysicalDevicePushDescriptorPropertiesKHR& getPushDescriptorProperties() const {
+        return push_descriptor_properties_;
+    }
     const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const { return memory_properties_; }
     std::span<const VkQueueFamilyProperties> getQueueFamilies() const { return queue_families_; }
     std::uint32_t findSuitableQueueFamily(VkQueueFlags flags, std::uint32_t n = 0) const;
     bool isSuitableDevice(const uxs::db::value& caps) const;
+    bool isBindlessSupported() const;
+    bool isDescriptorBufferSupported() const;
+    bool isGraphicsPipelineLibrarySupported() const;
+    bool isShaderObjectSupported() const;
+    bool isMultiDrawSupported() const;
 
     bool loadExtensionProperties();
     bool loadFeaturesAndProperties();
@@ -104,6 +148,54 @@ class PhysicalDevice {
     std::vector<VkExtensionProperties> extensions_;
     VkPhysicalDeviceProperties properties_{};
     VkPhysicalDeviceFeatures features_{};
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptor_indexing_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+    };
+    VkPhysicalDeviceDescriptorIndexingProperties descriptor_indexing_properties_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+    };
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+    };
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT,
+    };
+    VkPhysicalDeviceBufferDeviceAddressFeatures buffer_device_address_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES,
+    };
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+    };
+    VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphics_pipeline_library_properties_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT,
+    };
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+    };
+    VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+    };
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT extended_dynamic_state2_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT,
+    };
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extended_dynamic_state3_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+    };
+    VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT vertex_attribute_divisor_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_FEATURES_EXT,
+    };
+    VkPhysicalDeviceVertexAttributeDivisorPropertiesEXT vertex_attribute_divisor_properties_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_PROPERTIES_EXT,
+    };
+    VkPhysicalDeviceMultiDrawFeaturesEXT multi_draw_features_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT,
+    };
+    VkPhysicalDeviceMultiDrawPropertiesEXT multi_draw_properties_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT,
+    };
+    VkPhysicalDevicePushDescriptorPropertiesKHR push_descriptor_properties_{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR,
+    };
     VkPhysicalDeviceMemoryProperties memory_properties_{};
     std::vector<VkQueueFamilyProperties> queue_families_;
 };
@@ -13,9 +13,17 @@ using namespace app3d::rel::vulkan;
 
 Sampler::Sampler(Device& device) : device_(util::not_null{&device}) {}
 
-Sampler::~Sampler() { device_->vkDestroySampler(sampler_, nullptr); }
+Sampler::~Sampler() {
+    device_->removeSampler(*this, desc_);
+    if (bindless_index_ != INVALID_UINT32_VALUE) {
+        device_->getBindlessHeap().remove(BindlessDescriptorHeap::ResourceType::SAMPLER, bindless_index_);
+    }
+    device_->vkDestroySampler(sampler_, nullptr);
+}
 
 bool Sampler::create(const SamplerDesc& desc) {
+    desc_ = desc;
+
     const VkSamplerCreateInfo create_info{
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
         .magFilter = TBL_VK_MIN_MAG_FILTER[unsigned(desc.filter)][1],
@@ -41,6 +49,11 @@ bool Sampler::create(const SamplerDesc& desc) {
         return false;
     }
 
+    if (device_->getBindlessHeap().isCreated()) {
+        bindless_index_ = device_->getBindlessHeap().addSampler(sampler_);
+        if (bindless_index_ == INVALID_UINT32_VALUE) { return false; }
+    }
+
     return true;
 }
 
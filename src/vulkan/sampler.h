@@ -2,6 +2,7 @@
 
 #include "vulkan_api.h"
 
+#include "common/core_defs.h"
 #include "interfaces/i_rendering_driver.h"
 
 namespace app3d::rel::vulkan {
@@ -19,11 +20,14 @@ class Sampler final : public util::ref_counter, public ISampler {
 
     //@{ ISampler
     util::ref_counter& getRefCounter() override { return *this; }
+    std::uint32_t getBindlessIndex() const override { return bindless_index_; }
     //@}
 
  private:
     util::ref_ptr<Device> device_;
+    SamplerDesc desc_{};
     VkSampler sampler_{VK_NULL_HANDLE};
+    std::uint32_t bindless_index_ = INVALID_UINT32_VALUE;
 };
 
 }  // namespace app3d::rel::vulkan
@@ -3,6 +3,8 @@
 #include "device.h"
 #include "vulkan_logger.h"
 
+#include <cstring>
+
 using namespace app3d;
 using namespace app3d::rel;
 using namespace app3d::rel::vulkan;
@@ -12,24 +14,52 @@ using namespace app3d::rel::vulkan;
 
 ShaderModule::ShaderModule(Device& device) : device_(util::not_null{&device}) {}
 
-ShaderModule::~ShaderModule() { device_->vkDestroyShaderModule(shader_module_, nullptr); }
+ShaderModule::~ShaderModule() {
+    if (id_ != 0) { device_->releaseShaderModuleId(id_); }
+    device_->vkDestroyShaderModule(shader_module_, nullptr);
+}
 
-bool ShaderModule::create(const DataBlob& bytecode) {
-    const VkShaderModuleCreateInfo create_info{
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = bytecode.getSize(),
-        .pCode = reinterpret_cast<const std::uint32_t*>(bytecode.getData()),
-    };
+bool ShaderModule::create(DataBlob bytecode) {
+    if (!createModule(bytecode.getBuffer())) { return false; }
+    if (device_->useShaderObject()) { bytecode_ = std::move(bytecode); }
+    return true;
+}
 
-    VkResult result = device_->vkCreateShaderModule(&create_info, nullptr, &shader_module_);
-    if (result != VK_SUCCESS) {
-        logError(LOG_VK "couldn't create shader module: {}", result);
-        return false;
+bool ShaderModule::create(std::span<const std::uint8_t> bytecode) {
+    if (!createModule(bytecode)) { return false; }
+    if (device_->useShaderObject()) {
+        bytecode_ = DataBlob(bytecode.size());
+        std::memcpy(bytecode_.getData(), bytecode.data(), bytecode.size());
     }
-
     return true;
 }
 
 //@{ IShaderModule
 
 //@}
+
+bool ShaderModule::createModule(std::span<const std::uint8_t> bytecode) {
+    if (!device_->useShaderObject()) {
+        const VkShaderModuleCreateInfo create_info{
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .codeSize = bytecode.size(),
+            .pCode = reinterpret_cast<const std::uint32_t*>(bytecode.data()),
+        };
+
+        VkResult result = device_->vkCreateShaderModule(&create_info, nullptr, &shader_module_);
+        if (result != VK_SUCCESS) {
+            logError(LOG_VK "couldn't create shader module: {}", result);
+            return false;
+        }
+    }
+
+    has_reflection_ = reflection_.parse(std::span{reinterpret_cast<const std::uint32_t*>(bytecode.data()),
+                                                  bytecode.size() / sizeof(std::uint32_t)});
+    if (!has_reflection_) {
+        logWarning(LOG_VK "couldn't reflect shader module, its layout and stage must be specified explicitly");
+        reflection_ = {};
+    }
+
+    id_ = device_->obtainShaderModuleId(bytecode);
+    return true;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "spirv_reflection.h"
 #include "vulkan_api.h"
 
 #include "interfaces/i_rendering_driver.h"
@@ -13,9 +14,16 @@ class ShaderModule final : public util::ref_counter, public IShaderModule {
     explicit ShaderModule(Device& device);
     ~ShaderModule() override;
 
-    bool create(const DataBlob& bytecode);
+    bool create(DataBlob bytecode);
+    bool create(std::span<const std::uint8_t> bytecode);
 
     VkShaderModule getHandle() { return shader_module_; }
+    // SPIR-V code is kept only if shader objects are used: they are created from it for each pipeline layout
+    const DataBlob& getBytecode() const { return bytecode_; }
+    std::uint64_t getId() const { return id_; }
+    // Modules without reflection can be used only with explicitly specified layouts and stages
+    bool hasReflection() const { return has_reflection_; }
+    const ShaderReflection& getReflection() const { return reflection_; }
 
     //@{ IShaderModule
     util::ref_counter& getRefCounter() override { return *this; }
@@ -24,6 +32,12 @@ class ShaderModule final : public util::ref_counter, public IShaderModule {
  private:
     util::ref_ptr<Device> device_;
     VkShaderModule shader_module_{VK_NULL_HANDLE};
+    DataBlob bytecode_;
+    std::uint64_t id_ = 0;  // modules with identical bytecode share the ID in pipeline state keys, 0 - no ID
+    bool has_reflection_ = false;
+    ShaderReflection reflection_;
+
+    bool createModule(std::span<const std::uint8_t> bytecode);
 };
 
 }  // namespace app3d::rel::vulkan
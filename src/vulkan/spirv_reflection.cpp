@@ -0,0 +1,424 @@
+#include "spirv_reflection.h"
+
+#include "common/core_defs.h"
+#include "common/logger.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace app3d;
+using namespace app3d::rel;
+using namespace app3d::rel::vulkan;
+
+namespace {
+
+// Subset of SPIR-V specification constants, which are needed for reflection
+namespace spv {
+
+constexpr std::uint32_t MAGIC_NUMBER = 0x07230203;
+constexpr std::uint32_t HEADER_SIZE = 5;
+
+enum Op : std::uint32_t {
+    OP_ENTRY_POINT = 15,
+    OP_TYPE_INT = 21,
+    OP_TYPE_FLOAT = 22,
+    OP_TYPE_VECTOR = 23,
+    OP_TYPE_MATRIX = 24,
+    OP_TYPE_IMAGE = 25,
+    OP_TYPE_SAMPLER = 26,
+    OP_TYPE_SAMPLED_IMAGE = 27,
+    OP_TYPE_ARRAY = 28,
+    OP_TYPE_RUNTIME_ARRAY = 29,
+    OP_TYPE_STRUCT = 30,
+    OP_TYPE_POINTER = 32,
+    OP_CONSTANT = 43,
+    OP_SPEC_CONSTANT = 50,
+    OP_VARIABLE = 59,
+    OP_DECORATE = 71,
+    OP_MEMBER_DECORATE = 72,
+};
+
+enum ExecutionModel : std::uint32_t {
+    EXECUTION_MODEL_VERTEX = 0,
+    EXECUTION_MODEL_FRAGMENT = 4,
+};
+
+enum StorageClass : std::uint32_t {
+    STORAGE_CLASS_UNIFORM_CONSTANT = 0,
+    STORAGE_CLASS_INPUT = 1,
+    STORAGE_CLASS_UNIFORM = 2,
+    STORAGE_CLASS_PUSH_CONSTANT = 9,
+    STORAGE_CLASS_STORAGE_BUFFER = 12,
+};
+
+enum Decoration : std::uint32_t {
+    DECORATION_BLOCK = 2,
+    DECORATION_BUFFER_BLOCK = 3,
+    DECORATION_ARRAY_STRIDE = 6,
+    DECORATION_MATRIX_STRIDE = 7,
+    DECORATION_BUILT_IN = 11,
+    DECORATION_NON_WRITABLE = 24,
+    DECORATION_LOCATION = 30,
+    DECORATION_BINDING = 33,
+    DECORATION_DESCRIPTOR_SET = 34,
+    DECORATION_OFFSET = 35,
+};
+
+constexpr std::uint32_t DIM_BUFFER = 5;
+
+// Universal limit of structure members
+constexpr std::uint32_t MAX_STRUCT_MEMBERS = 16383;
+
+// Minimal word count of instructions, which are kept for reflection, so their fixed operands are always present
+constexpr std::uint32_t getMinWordCount(std::uint32_t opcode) {
+    switch (opcode) {
+        case OP_TYPE_SAMPLER:
+        case OP_TYPE_STRUCT: return 2;
+        case OP_TYPE_FLOAT:
+        case OP_TYPE_SAMPLED_IMAGE:
+        case OP_TYPE_RUNTIME_ARRAY: return 3;
+        case OP_TYPE_INT:
+        case OP_TYPE_VECTOR:
+        case OP_TYPE_MATRIX:
+        case OP_TYPE_ARRAY:
+        case OP_TYPE_POINTER:
+        case OP_CONSTANT:
+        case OP_SPEC_CONSTANT:
+        case OP_VARIABLE: return 4;
+        case OP_TYPE_IMAGE: return 9;
+        default: return 1;
+    }
+}
+
+}  // namespace spv
+
+class SpirvParser {
+ public:
+    explicit SpirvParser(std::span<const std::uint32_t> code) : code_(code) {}
+
+    bool parse(ShaderReflection& reflection);
+
+ private:
+    struct Member {
+        std::uint32_t offset = INVALID_UINT32_VALUE;
+        std::uint32_t matrix_stride = 0;
+        bool is_non_writable = false;
+    };
+
+    struct Id {
+        std::uint32_t opcode = 0;
+        std::uint32_t word_index = 0;
+        std::uint32_t word_count = 0;
+        std::uint32_t set = 0;
+        std::uint32_t binding = INVALID_UINT32_VALUE;
+        std::uint32_t location = INVALID_UINT32_VALUE;
+        std::uint32_t array_stride = 0;
+        bool is_built_in = false;
+        bool is_block = false;
+        bool is_buffer_block = false;
+        std::vector<Member> members;
+    };
+
+    std::span<const std::uint32_t> code_;
+    std::vector<Id> ids_;
+
+    // Unknown ids refer to reserved id 0, which has no opcode
+    const Id& getId(std::uint32_t id) const { return ids_[id < ids_.size() ? id : 0]; }
+    std::uint32_t getOperand(const Id& id, std::uint32_t n) const {
+        return n < id.word_count ? code_[id.word_index + n] : 0;
+    }
+    Member& getMember(std::uint32_t id, std::uint32_t member);
+    std::uint32_t getConstantValue(std::uint32_t id) const;
+    std::uint32_t getTypeSize(std::uint32_t type_id, std::uint32_t matrix_stride) const;
+    bool getDescriptorType(std::uint32_t type_id, std::uint32_t storage_class, DescriptorType& type) const;
+    bool getVertexInputFormat(std::uint32_t type_id, Format& format) const;
+};
+
+SpirvParser::Member& SpirvParser::getMember(std::uint32_t id, std::uint32_t member) {
+    auto& members = ids_[id].members;
+    if (member >= members.size()) { members.resize(member + 1); }
+    return members[member];
+}
+
+std::uint32_t SpirvParser::getConstantValue(std::uint32_t id) const {
+    const auto& constant = getId(id);
+    if (constant.opcode != spv::OP_CONSTANT && constant.opcode != spv::OP_SPEC_CONSTANT) { return 0; }
+    return getOperand(constant, 3);
+}
+
+std::uint32_t SpirvParser::getTypeSize(std::uint32_t type_id, std::uint32_t matrix_stride) const {
+    const auto& type = getId(type_id);
+    switch (type.opcode) {
+        case spv::OP_TYPE_INT:
+        case spv::OP_TYPE_FLOAT: return getOperand(type, 2) / 8;
+        case spv::OP_TYPE_VECTOR: return getOperand(type, 3) * getTypeSize(getOperand(type, 2), 0);
+        case spv::OP_TYPE_MATRIX: {
+            const std::uint32_t column_count = getOperand(type, 3);
+            return column_count * (matrix_stride ? matrix_stride : getTypeSize(getOperand(type, 2), 0));
+        }
+        case spv::OP_TYPE_ARRAY: {
+            const std::uint32_t element_count = getConstantValue(getOperand(type, 3));
+            return element_count *
+                   (type.array_stride ? type.array_stride : getTypeSize(getOperand(type, 2), matrix_stride));
+        }
+        case spv::OP_TYPE_STRUCT: {
+            std::uint32_t size = 0;
+            const std::uint32_t member_count = type.word_count - 2;
+            for (std::uint32_t n = 0; n < member_count; ++n) {
+                const Member member = n < type.members.size() ? type.members[n] : Member{};
+                const std::uint32_t offset = member.offset != INVALID_UINT32_VALUE ? member.offset : size;
+                size = std::max(offset + getTypeSize(getOperand(type, 2 + n), member.matrix_stride), size);
+            }
+            return size;
+        }
+        default: break;
+    }
+    return 0;
+}
+
+bool SpirvParser::getDescriptorType(std::uint32_t type_id, std::uint32_t storage_class,
+                                    DescriptorType& desc_type) const {
+    const auto& type = getId(type_id);
+    switch (type.opcode) {
+        case spv::OP_TYPE_SAMPLER: desc_type = DescriptorType::SAMPLER; return true;
+        case spv::OP_TYPE_SAMPLED_IMAGE: desc_type = DescriptorType::COMBINED_TEXTURE_SAMPLER; return true;
+        case spv::OP_TYPE_IMAGE: {
+            const bool is_buffer = getOperand(type, 3) == spv::DIM_BUFFER;
+            if (getOperand(type, 7) == 2) {  // used without sampler: storage image
+                desc_type = is_buffer ? DescriptorType::RW_BUFFER : DescriptorType::RW_TEXTURE;
+            } else {
+                desc_type = is_buffer ? DescriptorType::BUFFER : DescriptorType::TEXTURE;
+            }
+            return true;
+        }
+        case spv::OP_TYPE_STRUCT: {
+            if (storage_class == spv::STORAGE_CLASS_UNIFORM && type.is_block) {
+                desc_type = DescriptorType::CONSTANT_BUFFER;
+                return true;
+            }
+            if (storage_class == spv::STORAGE_CLASS_STORAGE_BUFFER || type.is_buffer_block) {
+                const bool is_read_only = !type.members.empty() &&
+                                          std::ranges::all_of(type.members, [](const auto& member) {
+                                              return member.is_non_writable;
+                                          });
+                desc_type = is_read_only ? DescriptorType::STRUCTURED_BUFFER : DescriptorType::RW_STRUCTURED_BUFFER;
+                return true;
+            }
+        } break;
+        default: break;
+    }
+    return false;
+}
+
+bool SpirvParser::getVertexInputFormat(std::uint32_t type_id, Format& format) const {
+    const auto& type = getId(type_id);
+    std::uint32_t component_count = 1;
+    const Id* component_type = &type;
+    if (type.opcode == spv::OP_TYPE_VECTOR) {
+        component_count = getOperand(type, 3);
+        component_type = &getId(getOperand(type, 2));
+    }
+
+    if (component_count == 0 || component_count > 4 || getOperand(*component_type, 2) != 32) { return false; }
+
+    constexpr std::array float_formats{Format::R32_FLOAT, Format::R32G32_FLOAT, Format::R32G32B32_FLOAT,
+                                       Format::R32G32B32A32_FLOAT};
+    constexpr std::array int_formats{Format::R32_SINT, Format::R32G32_SINT, Format::R32G32B32_SINT,
+                                     Format::R32G32B32A32_SINT};
+    constexpr std::array uint_formats{Format::R32_UINT, Format::R32G32_UINT, Format::R32G32B32_UINT,
+                                      Format::R32G32B32A32_UINT};
+    switch (component_type->opcode) {
+        case spv::OP_TYPE_FLOAT: format = float_formats[component_count - 1]; return true;
+        case spv::OP_TYPE_INT: {
+            const bool is_signed = getOperand(*component_type, 3) != 0;
+            format = is_signed ? int_formats[component_count - 1] : uint_formats[component_count - 1];
+            return true;
+        }
+        default: break;
+    }
+    return false;
+}
+
+bool SpirvParser::parse(ShaderReflection& reflection) {
+    if (code_.size() < spv::HEADER_SIZE || code_[0] != spv::MAGIC_NUMBER) {
+        logError("invalid SPIR-V bytecode");
+        return false;
+    }
+
+    const std::uint32_t id_bound = code_[3];
+    ids_.resize(std::max(id_bound, 1u));
+
+    std::uint32_t execution_model = INVALID_UINT32_VALUE;
+    uxs::inline_dynarray<std::uint32_t, 32> variables;
+
+    for (std::uint32_t word_index = spv::HEADER_SIZE; word_index < code_.size();) {
+        const std::uint32_t opcode = code_[word_index] & 0xffff;
+        const std::uint32_t word_count = code_[word_index] >> 16;
+        if (word_count == 0 || word_index + word_count > code_.size()) {
+            logError("invalid SPIR-V bytecode");
+            return false;
+        }
+
+        // Out of range ids and missing operands are replaced with 0 to be reported after the instruction is processed
+        bool is_malformed = word_count < spv::getMinWordCount(opcode);
+        const auto operand = [this, word_index, word_count, &is_malformed](std::uint32_t n) {
+            if (n < word_count) { return code_[word_index + n]; }
+            is_malformed = true;
+            return 0u;
+        };
+        const auto result_id = [&operand, &is_malformed, id_bound](std::uint32_t n) {
+            const std::uint32_t id = operand(n);
+            if (id != 0 && id < id_bound) { return id; }
+            is_malformed = true;
+            return 0u;
+        };
+
+        switch (opcode) {
+            case spv::OP_ENTRY_POINT: {
+                if (execution_model == INVALID_UINT32_VALUE) { execution_model = operand(1); }
+            } break;
+            case spv::OP_TYPE_INT:
+            case spv::OP_TYPE_FLOAT:
+            case spv::OP_TYPE_VECTOR:
+            case spv::OP_TYPE_MATRIX:
+            case spv::OP_TYPE_IMAGE:
+            case spv::OP_TYPE_SAMPLER:
+            case spv::OP_TYPE_SAMPLED_IMAGE:
+            case spv::OP_TYPE_ARRAY:
+            case spv::OP_TYPE_RUNTIME_ARRAY:
+            case spv::OP_TYPE_STRUCT:
+            case spv::OP_TYPE_POINTER: {
+                auto& id = ids_[result_id(1)];
+                id.opcode = opcode, id.word_index = word_index, id.word_count = word_count;
+            } break;
+            case spv::OP_CONSTANT:
+            case spv::OP_SPEC_CONSTANT:
+            case spv::OP_VARIABLE: {
+                auto& id = ids_[result_id(2)];
+                id.opcode = opcode, id.word_index = word_index, id.word_count = word_count;
+                if (opcode == spv::OP_VARIABLE) { variables.push_back(result_id(2)); }
+            } break;
+            case spv::OP_DECORATE: {
+                auto& id = ids_[result_id(1)];
+                switch (operand(2)) {
+                    case spv::DECORATION_BLOCK: id.is_block = true; break;
+                    case spv::DECORATION_BUFFER_BLOCK: id.is_buffer_block = true; break;
+                    case spv::DECORATION_ARRAY_STRIDE: id.array_stride = operand(3); break;
+                    case spv::DECORATION_BUILT_IN: id.is_built_in = true; break;
+                    case spv::DECORATION_LOCATION: id.location = operand(3); break;
+                    case spv::DECORATION_BINDING: id.binding = operand(3); break;
+                    case spv::DECORATION_DESCRIPTOR_SET: id.set = operand(3); break;
+                    default: break;
+                }
+            } break;
+            case spv::OP_MEMBER_DECORATE: {
+                const std::uint32_t struct_id = result_id(1), member_index = operand(2);
+                if (member_index >= spv::MAX_STRUCT_MEMBERS) {
+                    is_malformed = true;
+                    break;
+                }
+                auto& member = getMember(struct_id, member_index);
+                switch (operand(3)) {
+                    case spv::DECORATION_MATRIX_STRIDE: member.matrix_stride = operand(4); break;
+                    case spv::DECORATION_NON_WRITABLE: member.is_non_writable = true; break;
+                    case spv::DECORATION_OFFSET: member.offset = operand(4); break;
+                    default: break;
+                }
+            } break;
+            default: break;
+        }
+
+        if (is_malformed) {
+            logError("invalid SPIR-V bytecode: malformed instruction {}", opcode);
+            return false;
+        }
+
+        word_index += word_count;
+    }
+
+    switch (execution_model) {
+        case spv::EXECUTION_MODEL_VERTEX: reflection.stage = ShaderStage::VERTEX_SHADER; break;
+        case spv::EXECUTION_MODEL_FRAGMENT: reflection.stage = ShaderStage::PIXEL_SHADER; break;
+        default: {
+            logError("unsupported SPIR-V execution model {}", execution_model);
+            return false;
+        }
+    }
+
+    for (const std::uint32_t variable_id : variables) {
+        const auto& variable = ids_[variable_id];
+        const std::uint32_t storage_class = getOperand(variable, 3);
+        const auto& pointer_type = getId(getOperand(variable, 1));
+        if (pointer_type.opcode != spv::OP_TYPE_POINTER) { continue; }
+
+        std::uint32_t type_id = getOperand(pointer_type, 3);
+
+        switch (storage_class) {
+            case spv::STORAGE_CLASS_UNIFORM_CONSTANT:
+            case spv::STORAGE_CLASS_UNIFORM:
+            case spv::STORAGE_CLASS_STORAGE_BUFFER: {
+                if (variable.binding == INVALID_UINT32_VALUE) { continue; }
+
+                std::uint32_t count = 1;
+                if (getId(type_id).opcode == spv::OP_TYPE_ARRAY) {
+                    count = getConstantValue(getOperand(getId(type_id), 3));
+                    type_id = getOperand(getId(type_id), 2);
+                } else if (getId(type_id).opcode == spv::OP_TYPE_RUNTIME_ARRAY) {
+                    count = 0;
+                    type_id = getOperand(getId(type_id), 2);
+                }
+
+                DescriptorType desc_type{};
+                if (!getDescriptorType(type_id, storage_class, desc_type)) {
+                    logError("unsupported type of descriptor (binding {})", variable.binding);
+                    return false;
+                }
+
+                reflection.descriptor_bindings.emplace_back(ShaderReflection::DescriptorBinding{
+                    .set = variable.set,
+                    .binding = variable.binding,
+                    .type = desc_type,
+                    .count = count,
+                });
+            } break;
+
+            case spv::STORAGE_CLASS_INPUT: {
+                if (reflection.stage != ShaderStage::VERTEX_SHADER || variable.is_built_in ||
+                    variable.location == INVALID_UINT32_VALUE) {
+                    continue;
+                }
+
+                Format format{};
+                if (!getVertexInputFormat(type_id, format)) {
+                    logError("unsupported type of vertex input (location {})", variable.location);
+                    return false;
+                }
+
+                reflection.vertex_inputs.emplace_back(
+                    ShaderReflection::VertexInput{.location = variable.location, .format = format});
+            } break;
+
+            case spv::STORAGE_CLASS_PUSH_CONSTANT: {
+                std::uint32_t offset = INVALID_UINT32_VALUE;
+                for (const auto& member : getId(type_id).members) { offset = std::min(member.offset, offset); }
+                if (offset == INVALID_UINT32_VALUE) { offset = 0; }
+                reflection.push_constant_offset = offset;
+                reflection.push_constant_size = getTypeSize(type_id, 0) - offset;
+            } break;
+
+            default: break;
+        }
+    }
+
+    std::ranges::sort(reflection.descriptor_bindings, {},
+                      [](const auto& desc) { return std::make_pair(desc.set, desc.binding); });
+    std::ranges::sort(reflection.vertex_inputs, {}, &ShaderReflection::VertexInput::location);
+    return true;
+}
+
+}  // namespace
+
+// --------------------------------------------------------
+// ShaderReflection class implementation
+
+bool ShaderReflection::parse(std::span<const std::uint32_t> code) { return SpirvParser(code).parse(*this); }
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "rel/enums.h"
+
+#include <uxs/dynarray.h>
+
+#include <cstdint>
+#include <span>
+
+namespace app3d::rel::vulkan {
+
+// Resource interface of a shader module extracted from its SPIR-V bytecode
+struct ShaderReflection {
+    struct DescriptorBinding {
+        std::uint32_t set;
+        std::uint32_t binding;
+        DescriptorType type;
+        std::uint32_t count;  // 0 - unbounded array, which can be provided only by the bindless set
+    };
+
+    struct VertexInput {
+        std::uint32_t location;
+        Format format;
+    };
+
+    ShaderStage stage = ShaderStage::ALL_STAGES;
+    uxs::inline_dynarray<DescriptorBinding, 16> descriptor_bindings;
+    uxs::inline_dynarray<VertexInput, 16> vertex_inputs;
+    std::uint32_t push_constant_offset = 0;
+    std::uint32_t push_constant_size = 0;
+
+    bool parse(std::span<const std::uint32_t> code);
+};
+
+}  // namespace app3d::rel::vulkan
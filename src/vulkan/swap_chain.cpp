@@ -260,6 +260,8 @@ RenderTargetResult SwapChain::submitFrameImage(std::uint32_t image_index, Comman
         ready_to_present = kit.sem_ready_to_present;
     }
 
+    device_->endFrame();
+
     if (++n_image_ == images_.size()) { n_image_ = 0; }
     return surface_->getPresentQueue().presentImages(std::array{ready_to_present},
                                                      {std::array{swap_chain_}, std::array{image_index}});
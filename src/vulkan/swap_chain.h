@@ -24,6 +24,7 @@ class SwapChain final : public FrameImageProvider, public ISwapChain {
     bool create(const uxs::db::value& opts);
 
     //@{ FrameImageProvider
+    VkImage getImage(std::uint32_t image_index) override { return images_[image_index]; }
     VkImageView getImageView(std::uint32_t image_index) override { return image_views_[image_index]; }
     std::uint32_t getImageCount() const override { return std::uint32_t(images_.size()); }
     std::uint32_t getFifCount() const override { return 3; }
@@ -13,6 +13,14 @@ constexpr std::array TBL_VK_FORMAT{
     VK_FORMAT_R32G32B32_SFLOAT,     // R32G32B32_FLOAT
     VK_FORMAT_R32G32B32A32_SFLOAT,  // R32G32B32A32_FLOAT
     VK_FORMAT_R8G8B8A8_UNORM,       // R8G8B8A8_UNORM
+    VK_FORMAT_R32_SINT,             // R32_SINT
+    VK_FORMAT_R32G32_SINT,          // R32G32_SINT
+    VK_FORMAT_R32G32B32_SINT,       // R32G32B32_SINT
+    VK_FORMAT_R32G32B32A32_SINT,    // R32G32B32A32_SINT
+    VK_FORMAT_R32_UINT,             // R32_UINT
+    VK_FORMAT_R32G32_UINT,          // R32G32_UINT
+    VK_FORMAT_R32G32B32_UINT,       // R32G32B32_UINT
+    VK_FORMAT_R32G32B32A32_UINT,    // R32G32B32A32_UINT
 };
 
 constexpr std::array TBL_VK_PRIMITIVE_TOPOLOGY{
@@ -24,10 +32,25 @@ constexpr std::array TBL_VK_PRIMITIVE_TOPOLOGY{
     VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,  // TRIANGLE_STRIP
 };
 
+constexpr std::array TBL_VK_VERTEX_INPUT_RATE{
+    // VertexInputRate::
+    VK_VERTEX_INPUT_RATE_VERTEX,    // VERTEX
+    VK_VERTEX_INPUT_RATE_INSTANCE,  // INSTANCE
+};
+
 constexpr std::array TBL_VK_BUFFER_USAGE{
     // BufferType::
-    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,   // VERTEX
-    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,  // CONSTANT
+    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,    // VERTEX
+    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,   // CONSTANT
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,   // STRUCTURED
+    VK_BUFFER_USAGE_INDEX_BUFFER_BIT,     // INDEX
+    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,  // INDIRECT
+};
+
+constexpr std::array TBL_VK_INDEX_TYPE{
+    // IndexType::
+    VK_INDEX_TYPE_UINT16,  // UINT16
+    VK_INDEX_TYPE_UINT32,  // UINT32
 };
 
 constexpr std::array TBL_VK_SHADER_STAGE{
@@ -89,4 +112,69 @@ constexpr std::array TBL_VK_ADDRESS_MODE{
     VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE,  // MIRROR_CLAMP_TO_EDGE
 };
 
+constexpr std::array TBL_VK_CULL_MODE{
+    // CullMode::
+    VkCullModeFlags(VK_CULL_MODE_NONE),       // NONE
+    VkCullModeFlags(VK_CULL_MODE_FRONT_BIT),  // FRONT
+    VkCullModeFlags(VK_CULL_MODE_BACK_BIT),   // BACK
+};
+
+constexpr std::array TBL_VK_FRONT_FACE{
+    // FrontFace::
+    VK_FRONT_FACE_COUNTER_CLOCKWISE,  // COUNTER_CLOCKWISE
+    VK_FRONT_FACE_CLOCKWISE,          // CLOCKWISE
+};
+
+constexpr std::array TBL_VK_POLYGON_MODE{
+    // PolygonMode::
+    VK_POLYGON_MODE_FILL,   // FILL
+    VK_POLYGON_MODE_LINE,   // WIREFRAME
+    VK_POLYGON_MODE_POINT,  // POINT
+};
+
+constexpr std::array TBL_VK_COMPARE_OP{
+    // CompareOp::
+    VK_COMPARE_OP_NEVER,             // NEVER
+    VK_COMPARE_OP_LESS,              // LESS
+    VK_COMPARE_OP_EQUAL,             // EQUAL
+    VK_COMPARE_OP_LESS_OR_EQUAL,     // LESS_EQUAL
+    VK_COMPARE_OP_GREATER,           // GREATER
+    VK_COMPARE_OP_NOT_EQUAL,         // NOT_EQUAL
+    VK_COMPARE_OP_GREATER_OR_EQUAL,  // GREATER_EQUAL
+    VK_COMPARE_OP_ALWAYS,            // ALWAYS
+};
+
+constexpr std::array TBL_VK_BLEND_FACTOR{
+    // BlendFactor::
+    VK_BLEND_FACTOR_ZERO,                 // ZERO
+    VK_BLEND_FACTOR_ONE,                  // ONE
+    VK_BLEND_FACTOR_SRC_COLOR,            // SRC_COLOR
+    VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR,  // INV_SRC_COLOR
+    VK_BLEND_FACTOR_SRC_ALPHA,            // SRC_ALPHA
+    VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,  // INV_SRC_ALPHA
+    VK_BLEND_FACTOR_DST_COLOR,            // DEST_COLOR
+    VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR,  // INV_DEST_COLOR
+    VK_BLEND_FACTOR_DST_ALPHA,            // DEST_ALPHA
+    VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA,  // INV_DEST_ALPHA
+};
+
+constexpr std::array TBL_VK_BLEND_OP{
+    // BlendOp::
+    VK_BLEND_OP_ADD,               // ADD
+    VK_BLEND_OP_SUBTRACT,          // SUBTRACT
+    VK_BLEND_OP_REVERSE_SUBTRACT,  // REV_SUBTRACT
+    VK_BLEND_OP_MIN,               // MIN
+    VK_BLEND_OP_MAX,               // MAX
+};
+
+constexpr std::array TBL_VK_DYNAMIC_STATE{
+    // DynamicStateType::
+    VK_DYNAMIC_STATE_CULL_MODE,               // CULL_MODE
+    VK_DYNAMIC_STATE_FRONT_FACE,              // FRONT_FACE
+    VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,       // DEPTH_TEST
+    VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE,       // DEPTH_BIAS
+    VK_DYNAMIC_STATE_POLYGON_MODE_EXT,        // POLYGON_MODE
+    VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT,  // BLEND_STATE
+};
+
 }  // namespace app3d::rel::vulkan
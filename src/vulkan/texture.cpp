@@ -16,6 +16,9 @@ using namespace app3d::rel::vulkan;
 Texture::Texture(Device& device) : device_(util::not_null{&device}) {}
 
 Texture::~Texture() {
+    if (bindless_index_ != INVALID_UINT32_VALUE) {
+        device_->getBindlessHeap().remove(BindlessDescriptorHeap::ResourceType::TEXTURE, bindless_index_);
+    }
     device_->vkDestroyImageView(image_view_, nullptr);
     vmaDestroyImage(device_->getAllocator(), image_, allocation_);
 }
@@ -90,6 +93,11 @@ bool Texture::create(const TextureDesc& desc) {
         return false;
     }
 
+    if (device_->getBindlessHeap().isCreated()) {
+        bindless_index_ = device_->getBindlessHeap().addTexture(image_view_);
+        if (bindless_index_ == INVALID_UINT32_VALUE) { return false; }
+    }
+
     return true;
 }
 
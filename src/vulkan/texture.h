@@ -2,6 +2,8 @@
 
 #include "frame_image_provider.h"
 
+#include "common/core_defs.h"
+
 namespace app3d::rel::vulkan {
 
 class Device;
@@ -14,6 +16,7 @@ class Texture final : public FrameImageProvider, public ITexture {
     bool create(const TextureDesc& desc);
 
     //@{ FrameImageProvider
+    VkImage getImage(std::uint32_t image_index) override { return image_; }
     VkImageView getImageView(std::uint32_t image_index) override { return image_view_; }
     std::uint32_t getImageCount() const override { return 1; }
     std::uint32_t getFifCount() const override { return 1; }
@@ -38,6 +41,7 @@ class Texture final : public FrameImageProvider, public ITexture {
     bool updateTexture(const std::uint8_t* data, std::uint32_t first_subresource,
                        std::span<const UpdateTextureDesc> update_subresource_descs) override;
     util::ref_ptr<IRenderTarget> createRenderTarget(const uxs::db::value& opts) override;
+    std::uint32_t getBindlessIndex() const override { return bindless_index_; }
     //@}
 
  private:
@@ -48,6 +52,7 @@ class Texture final : public FrameImageProvider, public ITexture {
     VkImage image_{VK_NULL_HANDLE};
     VmaAllocation allocation_{VK_NULL_HANDLE};
     VkImageView image_view_{VK_NULL_HANDLE};
+    std::uint32_t bindless_index_ = INVALID_UINT32_VALUE;
 };
 
 }  // namespace app3d::rel::vulkan
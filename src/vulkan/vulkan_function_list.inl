@@ -37,6 +37,8 @@ INSTANCE_LEVEL_VK_FUNCTION(vkEnumeratePhysicalDevices)
 INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkEnumerateDeviceExtensionProperties)
 INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceProperties)
 INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceFeatures)
+INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceProperties2)
+INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceFeatures2)
 INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceQueueFamilyProperties)
 INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceMemoryProperties)
 INSTANCE_LEVEL_VK_FUNCTION_PHYDEV(vkGetPhysicalDeviceFormatProperties)
@@ -146,13 +148,21 @@ DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdCopyBufferToImage)
 DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdBindPipeline)
 DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdSetViewport)
 DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdSetScissor)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdSetLineWidth)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdSetDepthBias)
 DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdBindVertexBuffers)
 DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdBindDescriptorSets)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdPushConstants)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdBindIndexBuffer)
 DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdDraw)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdDrawIndexed)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdDrawIndirect)
+DEVICE_LEVEL_VK_FUNCTION_CMD(vkCmdDrawIndexedIndirect)
 
 DEVICE_LEVEL_VK_FUNCTION(vkCreateBuffer)
 DEVICE_LEVEL_VK_FUNCTION(vkDestroyBuffer)
 DEVICE_LEVEL_VK_FUNCTION(vkGetBufferMemoryRequirements)
+DEVICE_LEVEL_VK_FUNCTION(vkGetBufferDeviceAddress)
 DEVICE_LEVEL_VK_FUNCTION(vkGetImageMemoryRequirements)
 DEVICE_LEVEL_VK_FUNCTION(vkAllocateMemory)
 DEVICE_LEVEL_VK_FUNCTION(vkFreeMemory)
@@ -170,6 +180,9 @@ DEVICE_LEVEL_VK_FUNCTION(vkDestroyDescriptorSetLayout)
 DEVICE_LEVEL_VK_FUNCTION(vkAllocateDescriptorSets)
 DEVICE_LEVEL_VK_FUNCTION(vkFreeDescriptorSets)
 DEVICE_LEVEL_VK_FUNCTION(vkUpdateDescriptorSets)
+DEVICE_LEVEL_VK_FUNCTION(vkCreateDescriptorUpdateTemplate)
+DEVICE_LEVEL_VK_FUNCTION(vkDestroyDescriptorUpdateTemplate)
+DEVICE_LEVEL_VK_FUNCTION(vkUpdateDescriptorSetWithTemplate)
 
 #undef DEVICE_LEVEL_VK_FUNCTION
 #undef DEVICE_LEVEL_VK_FUNCTION_QUEUE
@@ -196,6 +209,51 @@ DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(vkAcquireNextImageKHR, VK_KHR_SWAPCHAIN_
 DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_QUEUE(vkQueuePresentKHR, VK_KHR_SWAPCHAIN_EXTENSION_NAME)
 DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetPrimitiveTopologyEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
 DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdBindVertexBuffers2EXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetViewportWithCountEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetScissorWithCountEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetCullModeEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetFrontFaceEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDepthTestEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDepthWriteEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDepthCompareOpEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDepthBoundsTestEnableEXT,
+                                            VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetStencilTestEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetRasterizerDiscardEnableEXT,
+                                            VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDepthBiasEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetPrimitiveRestartEnableEXT,
+                                            VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetPolygonModeEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetRasterizationSamplesEXT,
+                                            VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetSampleMaskEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetAlphaToCoverageEnableEXT,
+                                            VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetAlphaToOneEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetLogicOpEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetColorBlendEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetColorWriteMaskEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDepthClampEnableEXT, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetColorBlendEquationEXT,
+                                            VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdPushDescriptorSetKHR, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(vkGetDescriptorSetLayoutSizeEXT, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(vkGetDescriptorSetLayoutBindingOffsetEXT,
+                                        VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(vkGetDescriptorEXT, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdBindDescriptorBuffersEXT, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetDescriptorBufferOffsetsEXT, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdBeginRenderingKHR, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdEndRenderingKHR, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(vkCreateShadersEXT, VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION(vkDestroyShaderEXT, VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdBindShadersEXT, VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdSetVertexInputEXT, VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdDrawMultiEXT, VK_EXT_MULTI_DRAW_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdDrawMultiIndexedEXT, VK_EXT_MULTI_DRAW_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdDrawIndirectCountKHR, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)
+DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_CMD(vkCmdDrawIndexedIndirectCountKHR, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)
 
 #undef DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION
 #undef DEVICE_LEVEL_VK_FUNCTION_FROM_EXTENSION_QUEUE